@@ -1,8 +1,12 @@
 #include "appcommunicator.h"
 #include "luascriptcontroller.h"
+#include "backend/ipcclient.h"
+#include "backend/latencyprobe.h"
 
 #include <QGuiApplication>
 #include <QQuickWindow>
+#include <QEventLoop>
+#include <QSaveFile>
 #include <QDebug>
 
 #ifdef Q_OS_WIN
@@ -19,56 +23,76 @@ QString AppCommunicator::runningFilePath = "";
 AppCommunicator::AppCommunicator(QSharedPointer<LuaScriptController> ptrLuaScriptController, QObject* parent)
     : QObject(parent),
     ptrLuaScriptController(ptrLuaScriptController),
-    localServer(nullptr)
+    instanceServer(nullptr),
+    ipcServer(nullptr),
+    messageJournal(nullptr),
+    diagnosticsRing(nullptr)
 {
-    // Create a local server
-    this->localServer = new QLocalServer(this);
-    if (this->localServer->listen(serverName))
-    {
-        connect(this->localServer, &QLocalServer::newConnection, this, &AppCommunicator::handleNewConnection);
-        qDebug() << "NOWALuaScript local server started.";
-    }
-    else
+    // Further instances hand their scripts over this server and quit
+    this->instanceServer = new IpcServer(IpcProtocol::instanceServerName, this);
+    connect(this->instanceServer, &IpcServer::signal_messageReceived, this, &AppCommunicator::handleInstanceMessage);
+
+    // A shell loop, which opens 50 scripts, asks 50 times for activation, the window is raised once
+    this->activationTimer.setSingleShot(true);
+    this->activationTimer.setInterval(50);
+    connect(&this->activationTimer, &QTimer::timeout, this, &AppCommunicator::activationRequested);
+
+    // Persistent binary channel, NOWA-Design sends its messages over it without file system round trips.
+    // The xml files below are still read for versions of NOWA-Design, which do not use the channel yet.
+    this->ipcServer = new IpcServer(IpcProtocol::ipcServerName, this);
+    connect(this->ipcServer, &IpcServer::signal_messageReceived, this, &AppCommunicator::handleIpcMessage);
+
+    // Append only journal of sequence numbered messages, only the new entries are read on a change, in order and without duplicates
+    // It lives in a folder of its own, appending to it does not cause scans of the xml folder below.
+    this->messageJournal = new MessageJournal(MessageJournal::defaultFilePathName, this);
+    connect(this->messageJournal, &MessageJournal::signal_messageReceived, this, &AppCommunicator::handleIpcMessage);
+
+    // Runtime errors, which the game reports on every frame, come through shared memory and are drained once per frame
+    this->diagnosticsRing = new DiagnosticsRing(DiagnosticsRing::defaultKey, this);
+    connect(this->diagnosticsRing, &DiagnosticsRing::signal_messageReceived, this, [this](const IpcProtocol::Message& message, int count)
+            {
+                if (IpcProtocol::MessageType::LuaRuntimeErrors == message.type)
+                {
+                    this->handleMessage("LuaRuntimeErrors", message.filePathName, message.errorMessage, message.line, message.start, message.end, count, message.timestamp);
+                }
+                else
+                {
+                    this->handleIpcMessage(message);
+                }
+            });
+
+    // The ring has one consumer, the instance, which NOWA-Design is connected to. Another one, e.g. a debug build started next to it,
+    // would take the reports away from it.
+    if (true == this->ipcServer->isListening() && true == this->diagnosticsRing->create())
     {
-        qDebug() << "Failed to start NOWALuaScript local server:" << this->localServer->errorString();
+        this->diagnosticsRing->startDraining();
     }
 
     // Set the path to the directory instead of a specific file
     QString watchDirectory = QString(TARGET_PATH) + "/NOWALuaScript/bin/";
     this->fileWatcher.addPath(watchDirectory);
 
+    // Xml files of older NOWA-Design versions. One write causes a burst of directory changes, they are coalesced into one scan
+    this->xmlScanTimer.setSingleShot(true);
+    this->xmlScanTimer.setInterval(100);
+    connect(&this->xmlScanTimer, &QTimer::timeout, this, &AppCommunicator::readXmlFiles);
+
     // Connect to the directoryChanged signal
     connect(&fileWatcher, &QFileSystemWatcher::directoryChanged, this, [=](const QString& path)
             {
-                QTimer::singleShot(100, [=]() {  // Adjust the delay as needed
-                    QDir dir(watchDirectory);
-                    QStringList xmlFiles = dir.entryList({"*.xml"}, QDir::Files);
-
-                    for (const QString& fileName : xmlFiles)
-                    {
-                        qDebug() << "Detected change in XML file:" << fileName;
-                        this->readXmlFile(watchDirectory + "/" + fileName);
-                    }
-                });
+                Q_UNUSED(path)
+                if (false == this->xmlScanTimer.isActive())
+                {
+                    this->xmlScanTimer.start();
+                }
             });
 
-
-    QDir dir(watchDirectory);
-    QStringList xmlFiles = dir.entryList({"*.xml"}, QDir::Files);
-
-    for (const QString& fileName : xmlFiles)
-    {
-        qDebug() << "Detected change in XML file:" << fileName;
-        this->readXmlFile(watchDirectory + "/" + fileName);
-    }
+    this->readXmlFiles();
 }
 
 AppCommunicator::~AppCommunicator()
 {
-    if (nullptr != this->localServer)
-    {
-        this->localServer->close();
-    }
+
 }
 
 void AppCommunicator::onFileChanged(const QString& path)
@@ -143,6 +167,7 @@ void AppCommunicator::readXmlFile(const QString& filePath)
     int line = -1;
     int start = -1;
     int end = -1;
+    qint64 sentTimestamp = 0;
 
     // Parse the XML file
     while (!xmlReader.atEnd() && !xmlReader.hasError())
@@ -166,6 +191,8 @@ void AppCommunicator::readXmlFile(const QString& filePath)
                 line = xmlReader.attributes().value("line").toInt();
                 start = xmlReader.attributes().value("start").toInt();
                 end = xmlReader.attributes().value("end").toInt();
+                // Optional, only a benchmark sets it
+                sentTimestamp = xmlReader.attributes().value("timestamp").toLongLong();
 
                 // Read the error message
                 errorMessage = xmlReader.readElementText();
@@ -190,10 +217,47 @@ void AppCommunicator::readXmlFile(const QString& filePath)
     qDebug() << "Start:" << start;
     qDebug() << "End:" << end;
 
+    this->handleMessage(messageId, filePathName, errorMessage, line, start, end, 1, sentTimestamp);
+
+#if 1
+    // Delete the file after reading
+    if (QFile::remove(filePath))
+    {
+        qDebug() << "XML file deleted successfully.";
+    }
+    else
+    {
+        qWarning() << "Failed to delete the XML file.";
+    }
+#endif
+}
+
+void AppCommunicator::readXmlFiles(void)
+{
+    QString watchDirectory = QString(TARGET_PATH) + "/NOWALuaScript/bin/";
+
+    QDir dir(watchDirectory);
+    QStringList xmlFiles = dir.entryList({"*.xml"}, QDir::Files);
+
+    for (const QString& fileName : xmlFiles)
+    {
+        qDebug() << "Detected change in XML file:" << fileName;
+        this->readXmlFile(watchDirectory + "/" + fileName);
+    }
+}
+
+void AppCommunicator::handleMessage(const QString& messageId, const QString& filePathName, const QString& errorMessage, int line, int start, int end, int hitCount,
+                                    qint64 sentTimestamp)
+{
     // Check for specific message ID
     if (messageId == "LuaRuntimeErrors")
     {
-        this->ptrLuaScriptController->slot_sendLuaScriptError(filePathName, errorMessage, line, start, end);
+#ifdef NOWA_LATENCY_PROBE
+        LatencyProbe::instance()->reportReceived(filePathName, line, sentTimestamp);
+#else
+        Q_UNUSED(sentTimestamp)
+#endif
+        this->ptrLuaScriptController->slot_sendLuaScriptError(filePathName, errorMessage, line, start, end, hitCount);
     }
     else if (messageId == "LuaScriptPath")
     {
@@ -203,56 +267,112 @@ void AppCommunicator::readXmlFile(const QString& filePath)
         // If NOWALuaScript.exe is opened, a message is send out from NOWA-Design with a lua path. Add it!
         this->ptrLuaScriptController->slot_createLuaScript(filePathName);
     }
+}
 
-#if 1
-    // Delete the file after reading
-    if (QFile::remove(filePath))
+void AppCommunicator::handleIpcMessage(const IpcProtocol::Message& message)
+{
+    switch (message.type)
     {
-        qDebug() << "XML file deleted successfully.";
+    case IpcProtocol::MessageType::LuaRuntimeErrors:
+        this->handleMessage("LuaRuntimeErrors", message.filePathName, message.errorMessage, message.line, message.start, message.end, 1, message.timestamp);
+        break;
+    case IpcProtocol::MessageType::LuaScriptPath:
+        this->handleMessage("LuaScriptPath", message.filePathName, QString(), -1, -1, -1);
+        break;
+#ifdef NOWA_LATENCY_PROBE
+    case IpcProtocol::MessageType::Command:
+        // nowa_ipc_bench asks for the measured latencies, they are written to the given file.
+        // Only in builds with the ipc tools, a release editor does not write files on request of any local client.
+        if ("latencyReport" == message.command)
+        {
+            QSaveFile reportFile(message.filePathName);
+            if (true == reportFile.open(QIODevice::WriteOnly))
+            {
+                reportFile.write(LatencyProbe::instance()->takeReport());
+                reportFile.commit();
+            }
+        }
+        break;
+#endif
+    default:
+        break;
     }
-    else
+}
+
+void AppCommunicator::handleInstanceMessage(const IpcProtocol::Message& message)
+{
+    if (IpcProtocol::MessageType::LuaScriptPath == message.type)
     {
-        qWarning() << "Failed to delete the XML file.";
+        qDebug() << "Received file via IPC:" << message.filePathName;
+
+        // Send to LuaScriptController
+        Q_EMIT fileReceived(message.filePathName);
+    }
+    else if (IpcProtocol::MessageType::Command == message.type && "activate" == message.command)
+    {
+        if (false == this->activationTimer.isActive())
+        {
+            this->activationTimer.start();
+        }
     }
-#endif
 }
 
-bool AppCommunicator::isInstanceRunning(void)
+bool AppCommunicator::sendFilesToRunningInstance(const QStringList& filePathNames)
 {
     // Define the path for the "NOWALuaScript.running" file
     AppCommunicator::runningFilePath = QString(TARGET_PATH) + "/NOWALuaScript/bin/NOWALuaScript.running";
 
-#if 0
-    QFile runningFile(AppCommunicator::runningFilePath);
-    if (runningFile.open(QIODevice::ReadOnly))
-    {
-        return true;
-    }
+#ifdef Q_OS_WIN
+    // Windows only lets the running instance raise its window, if the process in the foreground allows it
+    AllowSetForegroundWindow(ASFW_ANY);
+#endif
+
+    IpcClient ipcClient(IpcProtocol::instanceServerName);
+
+    bool instanceRunning = false;
+    bool finished = false;
+    QEventLoop eventLoop;
 
-    // Create the file when the application starts
-    if (runningFile.open(QIODevice::WriteOnly))
+    QObject::connect(&ipcClient, &IpcClient::signal_connected, [&]()
+                     {
+                         instanceRunning = true;
+                     });
+
+    QObject::connect(&ipcClient, &IpcClient::signal_finished, [&](bool success)
+                     {
+                         Q_UNUSED(success)
+                         finished = true;
+                         eventLoop.quit();
+                     });
+
+    for (const QString& filePathName : filePathNames)
     {
-        runningFile.write("Instance is running");
-        runningFile.close();
+        IpcProtocol::Message message;
+        message.type = IpcProtocol::MessageType::LuaScriptPath;
+        message.filePathName = filePathName;
+        ipcClient.send(message);
     }
-    else
+
+    IpcProtocol::Message activateMessage;
+    activateMessage.type = IpcProtocol::MessageType::Command;
+    activateMessage.command = "activate";
+    ipcClient.send(activateMessage);
+
+    ipcClient.connectToServer(100);
+    ipcClient.finish();
+
+    // Without a server the connection may already have failed
+    if (false == finished)
     {
-        qWarning() << "Failed to create running file at" << AppCommunicator::runningFilePath;
+        eventLoop.exec();
     }
-    return false;
-#endif
 
-    QLocalSocket socket;
-    socket.connectToServer(AppCommunicator::serverName);
-
-    if (socket.waitForConnected(100))
+    if (true == instanceRunning)
     {
-        // Another instance is running
-        socket.disconnectFromServer();
-        return true;
+        qDebug() << "Sent" << filePathNames.size() << "file paths to running instance";
     }
 
-    return false;
+    return instanceRunning;
 }
 
 QString AppCommunicator::getRunningFilePath(void) const
@@ -289,53 +409,15 @@ void AppCommunicator::deleteRunningFile(void)
         }
     }
 
-    // Delete the file after reading
-    if (QFile::remove(AppCommunicator::runningFilePath))
-    {
-        qDebug() << "Running file deleted successfully.";
-    }
-}
-
-void AppCommunicator::sendFileToRunningInstance(const QString& filePath)
-{
-    QLocalSocket socket;
-    socket.connectToServer(AppCommunicator::serverName);
-
-    if (socket.waitForConnected(100))
+    // Messages of this session must not be delivered again on the next start
+    if (nullptr != this->messageJournal)
     {
-        QTextStream stream(&socket);
-        stream << filePath << Qt::endl;
-        socket.flush();
-        socket.waitForBytesWritten();
-        qDebug() << "Sent file path to running instance:" << filePath;
-        socket.disconnectFromServer();
+        this->messageJournal->remove();
     }
-    else
-    {
-        qDebug() << "Failed to connect to running instance";
-    }
-}
 
-void AppCommunicator::handleNewConnection()
-{
-    QLocalSocket *clientConnection = localServer->nextPendingConnection();
-    if (!clientConnection)
-    {
-        return;
-    }
-
-    connect(clientConnection, &QLocalSocket::disconnected, clientConnection, &QLocalSocket::deleteLater);
-
-    clientConnection->waitForReadyRead(100); // Ensure the message is received
-    QString filePath = QString::fromUtf8(clientConnection->readAll()).trimmed();
-
-    if (!filePath.isEmpty())
+    // Delete the file after reading
+    if (QFile::remove(AppCommunicator::runningFilePath))
     {
-        qDebug() << "Received file via IPC:" << filePath;
-
-        // Send to LuaScriptController
-        Q_EMIT fileReceived(filePath);
+        qDebug() << "Running file deleted successfully.";
     }
-
-    clientConnection->disconnectFromServer();
 }
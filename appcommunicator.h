@@ -5,9 +5,13 @@
 // #include <QAbstractNativeEventFilter>
 #include <QSharedPointer>
 #include <QFileSystemWatcher>
+#include <QStringList>
 
-#include <QLocalServer>
-#include <QLocalSocket>
+#include "backend/ipcserver.h"
+#include "backend/messagejournal.h"
+#include "backend/diagnosticsring.h"
+
+#include <QTimer>
 
 class LuaScriptController;
 
@@ -23,6 +27,11 @@ public:
 
     void readXmlFile(const QString& filePath);
 
+    // Hands a message of NOWA-Design to the controller, no matter whether it came as xml file or over the ipc channel.
+    // hitCount is how often an equal runtime error has been reported in a row. sentTimestamp is measured by the LatencyProbe, if it is set.
+    void handleMessage(const QString& messageId, const QString& filePathName, const QString& errorMessage, int line, int start, int end, int hitCount = 1,
+                       qint64 sentTimestamp = 0);
+
 
     QString getRunningFilePath(void) const;
 
@@ -31,29 +40,39 @@ public:
     void deleteRunningFile(void);
 
 public:
-    static bool isInstanceRunning();
-
-    static void sendFileToRunningInstance(const QString& filePath);
+    // Streams the scripts and the command "activate" to an already running instance and returns true, if there is one.
+    // Runs an own event loop, it is meant for the start of a second instance, before any window exists.
+    static bool sendFilesToRunningInstance(const QStringList& filePathNames);
 
     static void showWindowsMessageBox(const QString& title, const QString& message);
 Q_SIGNALS:
     void fileReceived(const QString& filePath);
+
+    void activationRequested(void);
 private slots:
     void onFileChanged(const QString& path);
 
     void onDirectoryChanged(const QString& path);
 
-    void handleNewConnection(void);
+    void handleInstanceMessage(const IpcProtocol::Message& message);
+
+    void handleIpcMessage(const IpcProtocol::Message& message);
+
+    void readXmlFiles(void);
 
 private:
-    static inline const QString serverName = "NOWALuaScriptInstance";
     static QString runningFilePath;
 private:
     QSharedPointer<LuaScriptController> ptrLuaScriptController;
 
     QString watchFilePathName;
     QFileSystemWatcher fileWatcher;
-    QLocalServer* localServer;
+    IpcServer* instanceServer;
+    IpcServer* ipcServer;
+    MessageJournal* messageJournal;
+    DiagnosticsRing* diagnosticsRing;
+    QTimer xmlScanTimer;
+    QTimer activationTimer;
 };
 
 #endif // APPCOMMUNICATOR_H
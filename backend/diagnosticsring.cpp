@@ -0,0 +1,248 @@
+#include "backend/diagnosticsring.h"
+
+#include <QtEndian>
+#include <QDebug>
+
+#include <cstring>
+#include <new>
+
+namespace
+{
+    const quint32 ringMagic = 0x41574F4E; // "NOWA"
+    const quint32 ringVersion = 1;
+
+    // Size field, type and sequence, the smallest possible frame
+    const quint32 minFrameSize = 4 + 1 + 4;
+
+    // Bytes of the size field and the type, the sequence follows and differs for every report
+    const quint32 sequenceOffset = 4 + 1;
+    const quint32 sequenceSize = 4;
+}
+
+DiagnosticsRing::DiagnosticsRing(const QString& key, QObject* parent)
+    : QObject(parent),
+    sharedMemory(QSharedMemory::legacyNativeKey(key)),
+    header(Q_NULLPTR),
+    slots(Q_NULLPTR),
+    repeatCount(0)
+{
+    connect(&this->drainTimer, &QTimer::timeout, this, &DiagnosticsRing::drain);
+}
+
+DiagnosticsRing::~DiagnosticsRing()
+{
+    this->drainTimer.stop();
+
+    if (true == this->sharedMemory.isAttached())
+    {
+        this->sharedMemory.detach();
+    }
+}
+
+bool DiagnosticsRing::create(quint32 slotCount)
+{
+    const qsizetype size = static_cast<qsizetype>(sizeof(Header)) + static_cast<qsizetype>(slotCount) * slotSize;
+
+    if (true == this->sharedMemory.create(size))
+    {
+        this->header = new (this->sharedMemory.data()) Header();
+        this->header->slotCount = slotCount;
+        this->header->slotSize = slotSize;
+        this->header->version = ringVersion;
+        this->slots = static_cast<char*>(this->sharedMemory.data()) + sizeof(Header);
+
+        // The magic comes last, so that the game does not use a half initialized header
+        std::atomic_thread_fence(std::memory_order_release);
+        this->header->magic = ringMagic;
+
+        qDebug() << "Diagnostics ring created, slots:" << slotCount << "bytes:" << size;
+        return true;
+    }
+
+    // Left over from a crashed editor or created by the game
+    if (QSharedMemory::AlreadyExists == this->sharedMemory.error() && true == this->attach())
+    {
+        this->header->readIndex.store(this->header->writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+        return true;
+    }
+
+    this->errorString = "Failed to create diagnostics ring: " + this->sharedMemory.errorString();
+    qWarning() << this->errorString;
+    return false;
+}
+
+bool DiagnosticsRing::attach(void)
+{
+    if (true == this->isAttached())
+    {
+        return true;
+    }
+
+    if (false == this->sharedMemory.isAttached() && false == this->sharedMemory.attach())
+    {
+        this->errorString = "Failed to attach to diagnostics ring: " + this->sharedMemory.errorString();
+        return false;
+    }
+
+    if (false == this->checkHeader())
+    {
+        this->sharedMemory.detach();
+        qWarning() << this->errorString;
+        return false;
+    }
+
+    return true;
+}
+
+bool DiagnosticsRing::isAttached(void) const
+{
+    return Q_NULLPTR != this->header;
+}
+
+bool DiagnosticsRing::checkHeader(void)
+{
+    if (this->sharedMemory.size() < static_cast<qsizetype>(sizeof(Header)))
+    {
+        this->errorString = "Diagnostics ring is too small";
+        return false;
+    }
+
+    Header* candidate = static_cast<Header*>(this->sharedMemory.data());
+
+    if (ringMagic != candidate->magic || ringVersion != candidate->version || slotSize != candidate->slotSize || 0 == candidate->slotCount)
+    {
+        this->errorString = "Diagnostics ring has an unknown layout";
+        return false;
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (this->sharedMemory.size() < static_cast<qsizetype>(sizeof(Header)) + static_cast<qsizetype>(candidate->slotCount) * slotSize)
+    {
+        this->errorString = "Diagnostics ring is smaller than its slots";
+        return false;
+    }
+
+    this->header = candidate;
+    this->slots = static_cast<char*>(this->sharedMemory.data()) + sizeof(Header);
+    return true;
+}
+
+char* DiagnosticsRing::slotAt(quint64 index) const
+{
+    return this->slots + (index % this->header->slotCount) * slotSize;
+}
+
+bool DiagnosticsRing::write(const IpcProtocol::Message& message)
+{
+    if (false == this->isAttached())
+    {
+        return false;
+    }
+
+    // resize keeps the capacity, after the first reports encoding does not allocate the frame anymore
+    this->frame.resize(0);
+    IpcProtocol::encode(message, this->frame);
+
+    const quint64 writeIndex = this->header->writeIndex.load(std::memory_order_relaxed);
+    const quint64 readIndex = this->header->readIndex.load(std::memory_order_acquire);
+
+    if (this->frame.size() > static_cast<qsizetype>(slotSize) || writeIndex - readIndex >= this->header->slotCount)
+    {
+        this->header->droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    std::memcpy(this->slotAt(writeIndex), this->frame.constData(), static_cast<size_t>(this->frame.size()));
+
+    // Publishes the slot, the editor does not read it before
+    this->header->writeIndex.store(writeIndex + 1, std::memory_order_release);
+    return true;
+}
+
+int DiagnosticsRing::drain(void)
+{
+    if (false == this->isAttached())
+    {
+        return 0;
+    }
+
+    const quint64 writeIndex = this->header->writeIndex.load(std::memory_order_acquire);
+    quint64 readIndex = this->header->readIndex.load(std::memory_order_relaxed);
+
+    const int count = static_cast<int>(writeIndex - readIndex);
+
+    for (; readIndex < writeIndex; ++readIndex)
+    {
+        const char* slot = this->slotAt(readIndex);
+        const quint32 frameSize = 4 + qFromLittleEndian<quint32>(slot);
+
+        if (frameSize < minFrameSize || frameSize > slotSize)
+        {
+            continue;
+        }
+
+        // The same report as before, only counted. Everything but the sequence must be equal.
+        if (this->repeatCount > 0 && static_cast<qsizetype>(frameSize) == this->lastFrame.size()
+            && 0 == std::memcmp(slot, this->lastFrame.constData(), sequenceOffset)
+            && 0 == std::memcmp(slot + sequenceOffset + sequenceSize, this->lastFrame.constData() + sequenceOffset + sequenceSize,
+                                frameSize - sequenceOffset - sequenceSize))
+        {
+            ++this->repeatCount;
+            continue;
+        }
+
+        this->flushRepeated();
+
+        this->lastFrame.resize(frameSize);
+        std::memcpy(this->lastFrame.data(), slot, frameSize);
+
+        this->frameReader.append(QByteArray::fromRawData(slot, frameSize));
+
+        if (true == this->frameReader.next(this->lastMessage))
+        {
+            this->repeatCount = 1;
+        }
+        else if (true == this->frameReader.hasError())
+        {
+            // Each slot holds a whole frame, a broken one must not affect the next
+            this->frameReader = IpcProtocol::FrameReader();
+        }
+    }
+
+    // The slots may be written again
+    this->header->readIndex.store(readIndex, std::memory_order_release);
+
+    this->flushRepeated();
+
+    return count;
+}
+
+void DiagnosticsRing::flushRepeated(void)
+{
+    if (this->repeatCount > 0)
+    {
+        const int count = this->repeatCount;
+        this->repeatCount = 0;
+        Q_EMIT signal_messageReceived(this->lastMessage, count);
+    }
+}
+
+void DiagnosticsRing::startDraining(int intervalMs)
+{
+    this->drainTimer.start(intervalMs);
+}
+
+quint64 DiagnosticsRing::getDroppedCount(void) const
+{
+    if (false == this->isAttached())
+    {
+        return 0;
+    }
+    return this->header->droppedCount.load(std::memory_order_relaxed);
+}
+
+QString DiagnosticsRing::getErrorString(void) const
+{
+    return this->errorString;
+}
@@ -0,0 +1,95 @@
+#ifndef DIAGNOSTICSRING_H
+#define DIAGNOSTICSRING_H
+
+#include <QObject>
+#include <QSharedMemory>
+#include <QTimer>
+#include <QByteArray>
+
+#include <atomic>
+
+#include "backend/ipcprotocol.h"
+
+// Lock free single producer, single consumer ring buffer in shared memory for runtime diagnostics of the running game.
+// A script, which breaks in update(dt), reports the same error on every frame. The game writes each report as an
+// IpcProtocol frame into a fixed size slot, which costs one memcpy and no file system access or system call.
+// The editor drains the ring once per frame, every 16 ms, into reused buffers and collapses reports, which are equal to the previous one,
+// so that thousands of reports per second become one signal per distinct error and drain.
+// If the ring is full, the game drops the report and counts it, it never waits for the editor.
+// Layout: Header, then slotCount slots of slotSize bytes, each holds one frame.
+// The game attaches, whenever it is not attached yet, e.g. once per second, because the editor may start later.
+class DiagnosticsRing : public QObject
+{
+    Q_OBJECT
+public:
+    static inline const QString defaultKey = "NOWALuaScriptDiagnostics";
+
+    static const quint32 defaultSlotCount = 2048;
+
+    static const quint32 slotSize = 1024;
+public:
+    explicit DiagnosticsRing(const QString& key = DiagnosticsRing::defaultKey, QObject* parent = Q_NULLPTR);
+
+    virtual ~DiagnosticsRing();
+
+    // Consumer side, creates the ring or attaches to the one, which the game has created. Reports older than this call are skipped.
+    bool create(quint32 slotCount = DiagnosticsRing::defaultSlotCount);
+
+    // Producer side, attaches to the ring of the editor
+    bool attach(void);
+
+    bool isAttached(void) const;
+
+    // Producer, false if the report has been dropped, because the ring is full or the frame does not fit into a slot
+    bool write(const IpcProtocol::Message& message);
+
+    // Consumer, takes all reports, which are in the ring now. Returns the count of reports.
+    int drain(void);
+
+    // Drains every intervalMs, 16 is one frame at 60 Hz
+    void startDraining(int intervalMs = 16);
+
+    quint64 getDroppedCount(void) const;
+
+    QString getErrorString(void) const;
+Q_SIGNALS:
+    // count is how often the message has been reported in a row
+    void signal_messageReceived(const IpcProtocol::Message& message, int count);
+private:
+    struct Header
+    {
+        quint32 magic;
+        quint32 version;
+        quint32 slotCount;
+        quint32 slotSize;
+        // Own cache lines, so that producer and consumer do not invalidate each other on every index update
+        alignas(64) std::atomic<quint64> writeIndex;
+        alignas(64) std::atomic<quint64> readIndex;
+        alignas(64) std::atomic<quint64> droppedCount;
+    };
+
+    static_assert(std::atomic<quint64>::is_always_lock_free, "The ring needs lock free 64 bit atomics, which work across processes");
+
+    bool checkHeader(void);
+
+    char* slotAt(quint64 index) const;
+
+    void flushRepeated(void);
+private:
+    QSharedMemory sharedMemory;
+    Header* header;
+    char* slots;
+    QString errorString;
+    QTimer drainTimer;
+
+    // Producer, reused for encoding
+    QByteArray frame;
+
+    // Consumer, the last distinct frame and how often it came in a row, the sequence is not compared
+    IpcProtocol::FrameReader frameReader;
+    QByteArray lastFrame;
+    IpcProtocol::Message lastMessage;
+    int repeatCount;
+};
+
+#endif // DIAGNOSTICSRING_H
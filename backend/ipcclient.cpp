@@ -0,0 +1,123 @@
+#include "backend/ipcclient.h"
+
+#include <QDebug>
+
+namespace
+{
+    // Bytes, which may wait in the socket, before the next frames are handed to it
+    const qint64 writeHighWater = 256 * 1024;
+
+    const qsizetype writeChunkSize = 64 * 1024;
+}
+
+IpcClient::IpcClient(const QString& serverName, QObject* parent)
+    : QObject(parent),
+    serverName(serverName),
+    socket(Q_NULLPTR),
+    writeOffset(0),
+    sequence(0),
+    finishing(false),
+    completed(false)
+{
+    this->socket = new QLocalSocket(this);
+
+    this->connectTimer.setSingleShot(true);
+    connect(&this->connectTimer, &QTimer::timeout, this, [this]()
+            {
+                qDebug() << "No answer of ipc server:" << this->serverName;
+                this->socket->abort();
+                this->complete(false);
+            });
+
+    connect(this->socket, &QLocalSocket::connected, this, [this]()
+            {
+                this->connectTimer.stop();
+                Q_EMIT signal_connected();
+                this->writePending();
+            });
+
+    connect(this->socket, &QLocalSocket::bytesWritten, this, [this](qint64 bytes)
+            {
+                Q_UNUSED(bytes)
+                this->writePending();
+            });
+
+    connect(this->socket, &QLocalSocket::disconnected, this, [this]()
+            {
+                this->complete(true == this->finishing && this->writeOffset == this->pendingFrames.size());
+            });
+
+    connect(this->socket, &QLocalSocket::errorOccurred, this, [this](QLocalSocket::LocalSocketError socketError)
+            {
+                // The server closing after everything has been written is no failure
+                if (QLocalSocket::PeerClosedError == socketError && true == this->finishing && this->writeOffset == this->pendingFrames.size())
+                {
+                    return;
+                }
+                qDebug() << "Ipc client error:" << this->serverName << this->socket->errorString();
+                this->connectTimer.stop();
+                this->complete(false);
+            });
+}
+
+void IpcClient::connectToServer(int timeoutMs)
+{
+    this->connectTimer.start(timeoutMs);
+    this->socket->connectToServer(this->serverName);
+}
+
+void IpcClient::send(IpcProtocol::Message message)
+{
+    message.sequence = ++this->sequence;
+    IpcProtocol::encode(message, this->pendingFrames);
+    this->writePending();
+}
+
+void IpcClient::finish(void)
+{
+    this->finishing = true;
+    this->writePending();
+}
+
+void IpcClient::writePending(void)
+{
+    if (true == this->completed || QLocalSocket::ConnectedState != this->socket->state())
+    {
+        return;
+    }
+
+    while (this->writeOffset < this->pendingFrames.size() && this->socket->bytesToWrite() < writeHighWater)
+    {
+        const qsizetype length = qMin(writeChunkSize, this->pendingFrames.size() - this->writeOffset);
+        const qint64 written = this->socket->write(this->pendingFrames.constData() + this->writeOffset, length);
+        if (written <= 0)
+        {
+            break;
+        }
+        this->writeOffset += written;
+    }
+
+    // Everything is in the socket, the buffer can start over
+    if (this->writeOffset == this->pendingFrames.size())
+    {
+        this->pendingFrames.clear();
+        this->writeOffset = 0;
+
+        // disconnectFromServer writes what is still buffered, before it closes
+        if (true == this->finishing)
+        {
+            this->socket->disconnectFromServer();
+        }
+    }
+}
+
+void IpcClient::complete(bool success)
+{
+    if (true == this->completed)
+    {
+        return;
+    }
+    this->completed = true;
+
+    Q_EMIT signal_finished(success);
+}
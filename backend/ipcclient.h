@@ -0,0 +1,46 @@
+#ifndef IPCCLIENT_H
+#define IPCCLIENT_H
+
+#include <QObject>
+#include <QLocalSocket>
+#include <QTimer>
+
+#include "backend/ipcprotocol.h"
+
+// Client side of an IpcServer connection, which never waits: messages are encoded into a buffer and written, whenever
+// the socket has taken the previous bytes. So the sender can stream any number of messages over one connection and
+// only as fast as the receiver reads them. finish closes the connection, when everything has been written.
+class IpcClient : public QObject
+{
+    Q_OBJECT
+public:
+    explicit IpcClient(const QString& serverName, QObject* parent = Q_NULLPTR);
+
+    // Gives up, if the server does not accept the connection within timeoutMs
+    void connectToServer(int timeoutMs = 1000);
+
+    // The sequence is counted by the client
+    void send(IpcProtocol::Message message);
+
+    void finish(void);
+Q_SIGNALS:
+    void signal_connected(void);
+
+    // Success is false, if there was no server or the connection broke before everything was written
+    void signal_finished(bool success);
+private:
+    void writePending(void);
+
+    void complete(bool success);
+private:
+    QString serverName;
+    QLocalSocket* socket;
+    QTimer connectTimer;
+    QByteArray pendingFrames;
+    qsizetype writeOffset;
+    quint32 sequence;
+    bool finishing;
+    bool completed;
+};
+
+#endif // IPCCLIENT_H
@@ -0,0 +1,225 @@
+#include "backend/ipcprotocol.h"
+
+#include <QtEndian>
+
+namespace
+{
+    // Type and sequence
+    const quint32 frameHeaderSize = 1 + 4;
+
+    template <typename T>
+    void appendNumber(QByteArray& target, T value)
+    {
+        char bytes[sizeof(T)];
+        qToLittleEndian<T>(value, bytes);
+        target.append(bytes, sizeof(T));
+    }
+
+    void appendString(QByteArray& target, const QString& value)
+    {
+        const QByteArray utf8 = value.toUtf8();
+        appendNumber<quint32>(target, static_cast<quint32>(utf8.size()));
+        target.append(utf8);
+    }
+
+    // Reads from a frame, which has already been checked to be complete. Fails, if a field would run over the end of the frame
+    class FieldReader
+    {
+    public:
+        FieldReader(const char* data, quint32 size)
+            : data(data),
+            size(size),
+            position(0),
+            valid(true)
+        {
+
+        }
+
+        template <typename T>
+        T readNumber(void)
+        {
+            if (false == this->valid || this->size - this->position < sizeof(T))
+            {
+                this->valid = false;
+                return T();
+            }
+
+            const T value = qFromLittleEndian<T>(this->data + this->position);
+            this->position += sizeof(T);
+            return value;
+        }
+
+        QString readString(void)
+        {
+            const quint32 length = this->readNumber<quint32>();
+            if (false == this->valid || this->size - this->position < length)
+            {
+                this->valid = false;
+                return QString();
+            }
+
+            const QString value = QString::fromUtf8(this->data + this->position, static_cast<qsizetype>(length));
+            this->position += length;
+            return value;
+        }
+
+        bool isValid(void) const
+        {
+            return this->valid;
+        }
+
+        bool atEnd(void) const
+        {
+            return this->position >= this->size;
+        }
+    private:
+        const char* data;
+        quint32 size;
+        quint32 position;
+        bool valid;
+    };
+}
+
+namespace IpcProtocol
+{
+    void encode(const Message& message, QByteArray& target)
+    {
+        const qsizetype sizePosition = target.size();
+
+        // The size is filled in, when the frame is complete
+        appendNumber<quint32>(target, 0);
+        appendNumber<quint8>(target, static_cast<quint8>(message.type));
+        appendNumber<quint32>(target, message.sequence);
+
+        switch (message.type)
+        {
+        case MessageType::LuaScriptPath:
+            appendString(target, message.filePathName);
+            break;
+        case MessageType::LuaRuntimeErrors:
+            appendString(target, message.filePathName);
+            appendString(target, message.errorMessage);
+            appendNumber<qint32>(target, message.line);
+            appendNumber<qint32>(target, message.start);
+            appendNumber<qint32>(target, message.end);
+            // Only when measured, so that equal reports of the game stay equal frames
+            if (0 != message.timestamp)
+            {
+                appendNumber<qint64>(target, message.timestamp);
+            }
+            break;
+        case MessageType::Ping:
+        case MessageType::Pong:
+            appendNumber<qint64>(target, message.timestamp);
+            break;
+        case MessageType::Command:
+            appendString(target, message.command);
+            appendString(target, message.filePathName);
+            break;
+        }
+
+        qToLittleEndian<quint32>(static_cast<quint32>(target.size() - sizePosition - 4), target.data() + sizePosition);
+    }
+
+    FrameReader::FrameReader()
+        : position(0)
+    {
+
+    }
+
+    void FrameReader::append(const QByteArray& data)
+    {
+        // Drops the consumed frames, usually there is at most a partial frame left, the capacity is kept
+        if (this->position > 0)
+        {
+            this->buffer.remove(0, this->position);
+            this->position = 0;
+        }
+
+        this->buffer.append(data);
+    }
+
+    bool FrameReader::next(Message& message)
+    {
+        while (false == this->hasError())
+        {
+            const qsizetype available = this->buffer.size() - this->position;
+            if (available < 4)
+            {
+                return false;
+            }
+
+            const char* frame = this->buffer.constData() + this->position;
+            const quint32 frameSize = qFromLittleEndian<quint32>(frame);
+
+            if (frameSize < frameHeaderSize || frameSize > maxFrameSize)
+            {
+                this->errorString = QString("Invalid frame size: %1").arg(frameSize);
+                return false;
+            }
+
+            if (available - 4 < static_cast<qsizetype>(frameSize))
+            {
+                return false;
+            }
+
+            this->position += 4 + frameSize;
+
+            FieldReader fieldReader(frame + 4, frameSize);
+            const quint8 type = fieldReader.readNumber<quint8>();
+
+            message = Message();
+            message.sequence = fieldReader.readNumber<quint32>();
+
+            switch (static_cast<MessageType>(type))
+            {
+            case MessageType::LuaScriptPath:
+                message.filePathName = fieldReader.readString();
+                break;
+            case MessageType::LuaRuntimeErrors:
+                message.filePathName = fieldReader.readString();
+                message.errorMessage = fieldReader.readString();
+                message.line = fieldReader.readNumber<qint32>();
+                message.start = fieldReader.readNumber<qint32>();
+                message.end = fieldReader.readNumber<qint32>();
+                if (false == fieldReader.atEnd())
+                {
+                    message.timestamp = fieldReader.readNumber<qint64>();
+                }
+                break;
+            case MessageType::Ping:
+            case MessageType::Pong:
+                message.timestamp = fieldReader.readNumber<qint64>();
+                break;
+            case MessageType::Command:
+                message.command = fieldReader.readString();
+                message.filePathName = fieldReader.readString();
+                break;
+            default:
+                // Newer sender, the frame is skipped
+                continue;
+            }
+
+            if (false == fieldReader.isValid())
+            {
+                this->errorString = QString("Truncated message of type: %1").arg(type);
+                return false;
+            }
+
+            message.type = static_cast<MessageType>(type);
+            return true;
+        }
+
+        return false;
+    }
+
+    bool FrameReader::hasError(void) const
+    {
+        return false == this->errorString.isEmpty();
+    }
+
+    QString FrameReader::getErrorString(void) const
+    {
+        return this->errorString;
+    }
+}
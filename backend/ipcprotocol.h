@@ -0,0 +1,77 @@
+#ifndef IPCPROTOCOL_H
+#define IPCPROTOCOL_H
+
+#include <QString>
+#include <QByteArray>
+
+// Binary messages between NOWA-Design and NOWALuaScript over a persistent QLocalSocket connection to the server ipcServerName.
+// Every message is one frame, all numbers little endian:
+//     quint32 size of the rest of the frame
+//     quint8  type
+//     quint32 sequence, counted by the sender
+//     then per type:
+//     LuaScriptPath:    string filePathName
+//     LuaRuntimeErrors: string filePathName, string errorMessage, qint32 line, qint32 start, qint32 end,
+//                       then only if not 0: qint64 timestamp, steady clock ns of the sender, which LatencyProbe measures against
+//     Ping, Pong:       qint64 timestamp of the sender, which the pong returns unchanged
+//     Command:          string command, e.g. "activate", string filePathName, which may be empty
+// A string is a quint32 byte count followed by the utf8 bytes. Unknown types are skipped, so that older editors keep working.
+// The MessageJournal file consists of the same frames.
+// A second instance of the editor streams its arguments over instanceServerName to the running one, as LuaScriptPath
+// messages followed by the command "activate".
+namespace IpcProtocol
+{
+    inline const QString ipcServerName = "NOWALuaScriptIpc";
+
+    inline const QString instanceServerName = "NOWALuaScriptInstance";
+
+    // Frames above this size are treated as a broken stream
+    const quint32 maxFrameSize = 16 * 1024 * 1024;
+
+    enum class MessageType : quint8
+    {
+        LuaScriptPath = 1,
+        LuaRuntimeErrors = 2,
+        Ping = 3,
+        Pong = 4,
+        Command = 5
+    };
+
+    struct Message
+    {
+        MessageType type = MessageType::Ping;
+        quint32 sequence = 0;
+        QString filePathName;
+        QString errorMessage;
+        QString command;
+        qint32 line = -1;
+        qint32 start = -1;
+        qint32 end = -1;
+        qint64 timestamp = 0;
+    };
+
+    // Appends the frame of the message to target, so that several messages can be sent with one write
+    void encode(const Message& message, QByteArray& target);
+
+    // Collects the bytes of a stream and cuts them into messages
+    class FrameReader
+    {
+    public:
+        FrameReader();
+
+        void append(const QByteArray& data);
+
+        // Takes the next complete message, false if there is none yet or the stream is broken
+        bool next(Message& message);
+
+        bool hasError(void) const;
+
+        QString getErrorString(void) const;
+    private:
+        QByteArray buffer;
+        qsizetype position;
+        QString errorString;
+    };
+}
+
+#endif // IPCPROTOCOL_H
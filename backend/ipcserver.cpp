@@ -0,0 +1,184 @@
+#include "backend/ipcserver.h"
+
+#include <QDebug>
+
+namespace
+{
+    // Bytes, which Qt buffers per connection, the rest waits in the kernel and finally at the sender
+    const qint64 socketReadBufferSize = 64 * 1024;
+
+    // Queued messages, above which the sockets are not read anymore
+    const int pendingMessagesHighWater = 256;
+
+    // Messages handed out per event loop turn, so that painting and input come in between
+    const int dispatchBatchSize = 8;
+
+    // A local connect is answered at once by a listening server and refused at once on a stale socket, the timeout is just a bound
+    const int aliveProbeTimeoutMs = 200;
+
+    bool isServerAlive(const QString& serverName)
+    {
+        QLocalSocket probe;
+        probe.connectToServer(serverName);
+        const bool alive = probe.waitForConnected(aliveProbeTimeoutMs);
+        probe.abort();
+        return alive;
+    }
+}
+
+IpcServer::IpcServer(const QString& serverName, QObject* parent)
+    : QObject(parent),
+    localServer(Q_NULLPTR),
+    replySequence(0)
+{
+    this->dispatchTimer.setSingleShot(true);
+    this->dispatchTimer.setInterval(0);
+    connect(&this->dispatchTimer, &QTimer::timeout, this, &IpcServer::dispatchMessages);
+
+    this->localServer = new QLocalServer(this);
+    this->localServer->setSocketOptions(QLocalServer::UserAccessOption);
+
+    // On unix the socket file of a crashed instance remains and blocks listening. But the name may as well belong to a running instance,
+    // removing its socket would take its messages over, so it is only removed, if nobody answers on it.
+    if (false == this->localServer->listen(serverName))
+    {
+        if (false == isServerAlive(serverName))
+        {
+            QLocalServer::removeServer(serverName);
+            this->localServer->listen(serverName);
+        }
+    }
+
+    if (true == this->localServer->isListening())
+    {
+        connect(this->localServer, &QLocalServer::newConnection, this, &IpcServer::handleNewConnection);
+        qDebug() << "NOWALuaScript ipc server started:" << this->localServer->fullServerName();
+    }
+    else
+    {
+        // E.g. a debug build started next to a running instance, which keeps serving the name
+        qWarning() << "Failed to start NOWALuaScript ipc server:" << serverName << this->localServer->errorString();
+    }
+}
+
+IpcServer::~IpcServer()
+{
+    this->localServer->close();
+}
+
+bool IpcServer::isListening(void) const
+{
+    return this->localServer->isListening();
+}
+
+void IpcServer::handleNewConnection(void)
+{
+    while (true == this->localServer->hasPendingConnections())
+    {
+        QLocalSocket* socket = this->localServer->nextPendingConnection();
+        socket->setReadBufferSize(socketReadBufferSize);
+
+        this->frameReaders.insert(socket, IpcProtocol::FrameReader());
+
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]()
+                {
+                    this->readMessages(socket);
+                });
+
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]()
+                {
+                    // The peer may close right after its last write, what is still buffered must not get lost
+                    this->readMessages(socket, true);
+                    this->frameReaders.remove(socket);
+                    socket->deleteLater();
+                });
+
+        // Data may have arrived together with the connection
+        this->readMessages(socket);
+    }
+}
+
+void IpcServer::readMessages(QLocalSocket* socket, bool force)
+{
+    auto it = this->frameReaders.find(socket);
+    if (this->frameReaders.end() == it)
+    {
+        return;
+    }
+
+    // Backpressure, the socket is read again, when the queue has been dispatched
+    if (false == force && this->pendingMessages.size() >= pendingMessagesHighWater)
+    {
+        return;
+    }
+
+    IpcProtocol::FrameReader& frameReader = it.value();
+    frameReader.append(socket->readAll());
+
+    IpcProtocol::Message message;
+    this->replyBuffer.clear();
+
+    while (true == frameReader.next(message))
+    {
+        if (IpcProtocol::MessageType::Ping == message.type)
+        {
+            IpcProtocol::Message pong;
+            pong.type = IpcProtocol::MessageType::Pong;
+            pong.sequence = ++this->replySequence;
+            pong.timestamp = message.timestamp;
+            IpcProtocol::encode(pong, this->replyBuffer);
+            continue;
+        }
+
+        this->pendingMessages.enqueue(message);
+    }
+
+    if (false == this->pendingMessages.isEmpty() && false == this->dispatchTimer.isActive())
+    {
+        this->dispatchTimer.start();
+    }
+
+    // Checked before writing, a write may report the disconnect of the peer right away, which removes the reader
+    const bool broken = frameReader.hasError();
+    const QString errorString = frameReader.getErrorString();
+
+    // All pongs of this read in one write
+    if (false == this->replyBuffer.isEmpty() && QLocalSocket::ConnectedState == socket->state())
+    {
+        socket->write(this->replyBuffer);
+        socket->flush();
+    }
+
+    if (true == broken)
+    {
+        // The stream cannot be resynchronized, the client has to connect again
+        qWarning() << "Broken ipc stream:" << errorString;
+        socket->abort();
+    }
+}
+
+void IpcServer::dispatchMessages(void)
+{
+    for (int i = 0; i < dispatchBatchSize && false == this->pendingMessages.isEmpty(); ++i)
+    {
+        Q_EMIT signal_messageReceived(this->pendingMessages.dequeue());
+    }
+
+    // Sockets, which have been held back, do not signal readyRead again for data they already buffered
+    if (this->pendingMessages.size() < pendingMessagesHighWater)
+    {
+        const QList<QLocalSocket*> sockets = this->frameReaders.keys();
+        for (QLocalSocket* socket : sockets)
+        {
+            if (socket->bytesAvailable() > 0)
+            {
+                this->readMessages(socket);
+            }
+        }
+    }
+
+    if (false == this->pendingMessages.isEmpty())
+    {
+        this->dispatchTimer.start();
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef IPCSERVER_H
+#define IPCSERVER_H
+
+#include <QObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QHash>
+#include <QQueue>
+#include <QTimer>
+
+#include "backend/ipcprotocol.h"
+
+// Server side of the persistent binary channel to NOWA-Design, see IpcProtocol for the frames.
+// NOWA-Design keeps one connection open and writes its messages as they occur, so that a message costs no file system
+// access and no polling delay. Pings are answered right away on the socket, so that a client can measure the round trip.
+// Nothing blocks: received messages are queued and handed out in small batches per event loop turn, so that a burst
+// of e.g. 50 scripts to open does not freeze the window. While the queue is full, the sockets are not read anymore.
+// Their read buffers are limited, so that the kernel buffer fills up and the sender has to wait instead of the editor.
+class IpcServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit IpcServer(const QString& serverName, QObject* parent = Q_NULLPTR);
+
+    virtual ~IpcServer();
+
+    bool isListening(void) const;
+Q_SIGNALS:
+    void signal_messageReceived(const IpcProtocol::Message& message);
+private Q_SLOTS:
+    void handleNewConnection(void);
+
+    void dispatchMessages(void);
+private:
+    // Reads and parses what the socket has, unless the queue is full. force is used for the rest of a closed connection.
+    void readMessages(QLocalSocket* socket, bool force = false);
+private:
+    QLocalServer* localServer;
+    QHash<QLocalSocket*, IpcProtocol::FrameReader> frameReaders;
+    QQueue<IpcProtocol::Message> pendingMessages;
+    QTimer dispatchTimer;
+    QByteArray replyBuffer;
+    quint32 replySequence;
+};
+
+#endif // IPCSERVER_H
@@ -0,0 +1,107 @@
+#include "backend/latencyprobe.h"
+
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    QString lineKey(const QString& filePathName, int line)
+    {
+        return QString(filePathName).replace("\\", "/") + ":" + QString::number(line);
+    }
+
+    QJsonObject statistics(QList<qint64> latencies)
+    {
+        QJsonObject result;
+        result["count"] = static_cast<qint64>(latencies.size());
+
+        if (true == latencies.isEmpty())
+        {
+            return result;
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+
+        auto percentile = [&latencies](double fraction)
+        {
+            const qsizetype index = qMin(latencies.size() - 1, static_cast<qsizetype>(fraction * latencies.size()));
+            return latencies[index] / 1000.0;
+        };
+
+        result["p50Us"] = percentile(0.5);
+        result["p99Us"] = percentile(0.99);
+        result["p999Us"] = percentile(0.999);
+        result["maxUs"] = latencies.last() / 1000.0;
+        return result;
+    }
+}
+
+LatencyProbe::LatencyProbe()
+    : coalescedCount(0)
+{
+
+}
+
+LatencyProbe* LatencyProbe::instance()
+{
+    static LatencyProbe instance;
+    return &instance;
+}
+
+qint64 LatencyProbe::now(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LatencyProbe::reportReceived(const QString& filePathName, int line, qint64 sentTimestamp)
+{
+    if (sentTimestamp <= 0)
+    {
+        return;
+    }
+
+    this->receiveLatencies.append(LatencyProbe::now() - sentTimestamp);
+
+    const QString key = lineKey(filePathName, line);
+    if (true == this->pendingTimestamps.contains(key))
+    {
+        ++this->coalescedCount;
+        return;
+    }
+    this->pendingTimestamps.insert(key, sentTimestamp);
+}
+
+void LatencyProbe::reportHighlighted(const QString& filePathName, int line)
+{
+    // Nothing is measured, the usual case
+    if (true == this->pendingTimestamps.isEmpty())
+    {
+        return;
+    }
+
+    auto it = this->pendingTimestamps.find(lineKey(filePathName, line));
+    if (this->pendingTimestamps.end() != it)
+    {
+        this->highlightLatencies.append(LatencyProbe::now() - it.value());
+        this->pendingTimestamps.erase(it);
+    }
+}
+
+QByteArray LatencyProbe::takeReport(void)
+{
+    QJsonObject report;
+    report["received"] = statistics(this->receiveLatencies);
+    report["highlighted"] = statistics(this->highlightLatencies);
+    report["coalesced"] = this->coalescedCount;
+    report["notHighlighted"] = static_cast<qint64>(this->pendingTimestamps.size());
+
+    this->receiveLatencies.clear();
+    this->highlightLatencies.clear();
+    this->pendingTimestamps.clear();
+    this->coalescedCount = 0;
+
+    return QJsonDocument(report).toJson(QJsonDocument::Indented);
+}
@@ -0,0 +1,38 @@
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QByteArray>
+
+// Measures, how long a runtime error takes from the game to the highlighted line in the editor. Only reports, which carry the
+// timestamp of their sender, are measured, e.g. those of nowa_ipc_bench. The timestamps are steady clock nanoseconds, which are
+// comparable between processes on the same machine. Runs on the gui thread only.
+// Coalesced reports of the same file and line are highlighted once, the oldest of them gives the latency.
+class LatencyProbe
+{
+public:
+    static LatencyProbe* instance();
+
+    // Steady clock ns, as the sender has to stamp its messages
+    static qint64 now(void);
+
+    // The report has arrived at AppCommunicator
+    void reportReceived(const QString& filePathName, int line, qint64 sentTimestamp);
+
+    // The line is about to be highlighted, see LuaHighlighter::setRuntimeErrorLine
+    void reportHighlighted(const QString& filePathName, int line);
+
+    // Json with count and p50, p99, p999, max in microseconds of both stages, the measurements are reset
+    QByteArray takeReport(void);
+private:
+    LatencyProbe();
+private:
+    QHash<QString, qint64> pendingTimestamps; // "filePathName:line" -> oldest not highlighted send time
+    QList<qint64> receiveLatencies;
+    QList<qint64> highlightLatencies;
+    qint64 coalescedCount;
+};
+
+#endif // LATENCYPROBE_H
@@ -0,0 +1,160 @@
+#include "backend/luaarena.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    const size_t alignment = alignof(std::max_align_t);
+
+    size_t alignUp(size_t size)
+    {
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+LuaArena::LuaArena(size_t blockSize, size_t memoryLimit)
+    : currentBlock(-1),
+    offset(0),
+    blockSize(alignUp(blockSize)),
+    memoryLimit(memoryLimit),
+    usedMemory(0),
+    reservedMemory(0),
+    lastPointer(Q_NULLPTR)
+{
+
+}
+
+LuaArena::~LuaArena()
+{
+    for (const Block& block : std::as_const(this->blocks))
+    {
+        std::free(block.data);
+    }
+}
+
+void* LuaArena::allocate(void* userData, void* pointer, size_t oldSize, size_t newSize)
+{
+    LuaArena* arena = static_cast<LuaArena*>(userData);
+
+    // Freed memory is only given back by reset
+    if (0 == newSize)
+    {
+        if (pointer == arena->lastPointer)
+        {
+            arena->offset = static_cast<char*>(pointer) - arena->blocks[arena->currentBlock].data;
+            arena->usedMemory -= alignUp(oldSize);
+            arena->lastPointer = Q_NULLPTR;
+        }
+        return Q_NULLPTR;
+    }
+
+    if (Q_NULLPTR != pointer && pointer == arena->lastPointer)
+    {
+        const Block& block = arena->blocks[arena->currentBlock];
+        const size_t start = static_cast<char*>(pointer) - block.data;
+
+        if (start + alignUp(newSize) <= block.size)
+        {
+            arena->offset = start + alignUp(newSize);
+            arena->usedMemory = arena->usedMemory - alignUp(oldSize) + alignUp(newSize);
+            return pointer;
+        }
+    }
+
+    // Shrinking keeps the memory where it is
+    if (Q_NULLPTR != pointer && newSize <= oldSize)
+    {
+        return pointer;
+    }
+
+    void* newPointer = arena->bump(newSize);
+
+    // Lua raises a memory error in this case
+    if (Q_NULLPTR == newPointer)
+    {
+        return Q_NULLPTR;
+    }
+
+    if (Q_NULLPTR != pointer)
+    {
+        std::memcpy(newPointer, pointer, qMin(oldSize, newSize));
+    }
+
+    return newPointer;
+}
+
+void LuaArena::reset(size_t retainedMemory)
+{
+    size_t keptMemory = 0;
+    int keptBlocks = 0;
+
+    while (keptBlocks < this->blocks.size() && keptMemory + this->blocks[keptBlocks].size <= qMax(retainedMemory, this->blockSize))
+    {
+        keptMemory += this->blocks[keptBlocks].size;
+        ++keptBlocks;
+    }
+
+    for (int i = keptBlocks; i < this->blocks.size(); ++i)
+    {
+        std::free(this->blocks[i].data);
+    }
+    this->blocks.resize(keptBlocks);
+
+    this->reservedMemory = keptMemory;
+    this->currentBlock = true == this->blocks.isEmpty() ? -1 : 0;
+    this->offset = 0;
+    this->usedMemory = 0;
+    this->lastPointer = Q_NULLPTR;
+}
+
+size_t LuaArena::getUsedMemory(void) const
+{
+    return this->usedMemory;
+}
+
+size_t LuaArena::getReservedMemory(void) const
+{
+    return this->reservedMemory;
+}
+
+void* LuaArena::bump(size_t size)
+{
+    size = alignUp(size);
+
+    // Moves on to the next kept block, if the current one is full
+    while (-1 == this->currentBlock || this->offset + size > this->blocks[this->currentBlock].size)
+    {
+        if (this->currentBlock + 1 >= this->blocks.size())
+        {
+            const size_t newBlockSize = qMax(this->blockSize, size);
+
+            if (this->reservedMemory + newBlockSize > this->memoryLimit)
+            {
+                return Q_NULLPTR;
+            }
+
+            Block block;
+            block.data = static_cast<char*>(std::malloc(newBlockSize));
+
+            if (Q_NULLPTR == block.data)
+            {
+                return Q_NULLPTR;
+            }
+
+            block.size = newBlockSize;
+            this->blocks.append(block);
+            this->reservedMemory += newBlockSize;
+        }
+
+        ++this->currentBlock;
+        this->offset = 0;
+    }
+
+    void* pointer = this->blocks[this->currentBlock].data + this->offset;
+    this->offset += size;
+    this->usedMemory += size;
+    this->lastPointer = pointer;
+
+    return pointer;
+}
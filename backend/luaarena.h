@@ -0,0 +1,49 @@
+#ifndef LUAARENA_H
+#define LUAARENA_H
+
+#include <QVector>
+
+#include <cstddef>
+
+// Bump allocator for lua states, which only live for one check. Lua's frees are ignored and memory is handed out from large blocks,
+// so that the whole state is thrown away at once by resetting the arena, instead of freeing object by object in lua_close.
+// The blocks are kept for the next state, so that a warmed up arena does not allocate at all.
+class LuaArena
+{
+public:
+    explicit LuaArena(size_t blockSize = 1024 * 1024, size_t memoryLimit = 256 * 1024 * 1024);
+
+    ~LuaArena();
+
+    // lua_Alloc, userData is the arena
+    static void* allocate(void* userData, void* pointer, size_t oldSize, size_t newSize);
+
+    // Forgets everything handed out so far, a state living in the arena must not be used anymore afterwards.
+    // Blocks beyond retainedMemory are given back, which only happens after an unusually large check.
+    void reset(size_t retainedMemory);
+
+    size_t getUsedMemory(void) const;
+
+    size_t getReservedMemory(void) const;
+private:
+    Q_DISABLE_COPY(LuaArena)
+
+    void* bump(size_t size);
+
+    struct Block
+    {
+        char* data = Q_NULLPTR;
+        size_t size = 0;
+    };
+private:
+    QVector<Block> blocks;
+    int currentBlock;
+    size_t offset; // Within the current block
+    size_t blockSize;
+    size_t memoryLimit;
+    size_t usedMemory;
+    size_t reservedMemory;
+    void* lastPointer; // The last allocation may grow in place, which is what lua does with its buffers and arrays most of the time
+};
+
+#endif // LUAARENA_H
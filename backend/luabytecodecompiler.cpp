@@ -0,0 +1,151 @@
+#include "backend/luabytecodecompiler.h"
+#include "backend/luastatepool.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QSemaphore>
+#include <QFileInfo>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <QDebug>
+
+extern "C"
+{
+#include <lobject.h>
+#include <lstate.h>
+#include <lundump.h>
+}
+
+LuaBytecodeCompiler::Result LuaBytecodeCompiler::compile(const QString& filePathName, const QByteArray& luaCode, bool stripDebugInfo)
+{
+    Result result;
+    result.filePathName = filePathName;
+    result.bytecodeFilePathName = getBytecodeFilePathName(filePathName);
+    result.sourceSize = luaCode.size();
+
+    // The states are shared with the syntax checks of the editor, a large project must not take all of them
+    static QSemaphore compileSlots(qMax(1, LuaStatePool::instance()->getMaxStates() - 1));
+    compileSlots.acquire();
+    QSemaphoreReleaser compileSlotReleaser(compileSlots);
+
+    lua_State* lua = LuaStatePool::instance()->acquire();
+    if (Q_NULLPTR == lua)
+    {
+        result.message = "No lua state available for compiling.";
+        return result;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Same chunk name, luaL_loadfile would give the script, so that the messages of the game do not change
+    const QByteArray chunkName = "@" + QFileInfo(filePathName).fileName().toUtf8();
+    int status = luaL_loadbuffer(lua, luaCode.constData(), static_cast<size_t>(luaCode.size()), chunkName.constData());
+
+    QByteArray bytecode;
+
+    if (0 == status)
+    {
+        // lua_dump cannot strip the debug info, so the dump function of ldump.c is called directly with the prototype of the loaded chunk
+        const Proto* proto = clvalue(lua->top - 1)->l.p;
+        status = luaU_dump(lua, proto, &LuaBytecodeCompiler::writeBytecode, &bytecode, true == stripDebugInfo ? 1 : 0);
+
+        if (0 != status)
+        {
+            result.message = "Could not dump the bytecode of: " + filePathName;
+        }
+    }
+    else
+    {
+        result.message = QString::fromUtf8(lua_tostring(lua, -1));
+    }
+
+    result.compileTimeMs = timer.nsecsElapsed() / 1000000.0;
+
+    LuaStatePool::instance()->release(lua);
+
+    if (0 != status)
+    {
+        return result;
+    }
+
+    // The game may load the bytecode at any time, it must never see a half written file
+    QSaveFile file(result.bytecodeFilePathName);
+
+    if (false == file.open(QIODevice::WriteOnly))
+    {
+        result.message = "Failed to write bytecode file: " + result.bytecodeFilePathName + " Error: " + file.errorString();
+        return result;
+    }
+
+    if (bytecode.size() != file.write(bytecode) || false == file.commit())
+    {
+        // Not committed, the temporary file is discarded and the old bytecode stays as it was
+        result.message = "Failed to write bytecode file: " + result.bytecodeFilePathName + " Error: " + file.errorString();
+        return result;
+    }
+
+    result.success = true;
+    result.bytecodeSize = bytecode.size();
+
+    return result;
+}
+
+LuaBytecodeCompiler::Result LuaBytecodeCompiler::compileFile(const QString& filePathName, bool stripDebugInfo)
+{
+    QFile file(filePathName);
+
+    if (false == file.open(QIODevice::ReadOnly))
+    {
+        Result result;
+        result.filePathName = filePathName;
+        result.message = "Unable to open file: " + filePathName;
+        return result;
+    }
+
+    const QByteArray luaCode = file.readAll();
+    file.close();
+
+    return compile(filePathName, luaCode, stripDebugInfo);
+}
+
+QList<LuaBytecodeCompiler::Result> LuaBytecodeCompiler::compileFolder(const QString& folderPath, bool stripDebugInfo, const std::function<void(const Result&)>& resultCallback)
+{
+    QStringList filePathNames;
+
+    QDirIterator it(folderPath, QStringList() << "*.lua", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        filePathNames.append(it.next());
+    }
+
+    // Each file is compiled in its own pooled state, compile bounds the count of files compiled at the same time below the size of the pool
+    return QtConcurrent::blockingMapped<QList<Result>>(filePathNames, [stripDebugInfo, resultCallback](const QString& filePathName)
+        {
+            const Result result = compileFile(filePathName, stripDebugInfo);
+
+            if (resultCallback)
+            {
+                resultCallback(result);
+            }
+
+            return result;
+        });
+}
+
+QString LuaBytecodeCompiler::getBytecodeFilePathName(const QString& filePathName)
+{
+    const QFileInfo fileInfo(filePathName);
+    return fileInfo.absolutePath() + "/" + fileInfo.completeBaseName() + ".luac";
+}
+
+int LuaBytecodeCompiler::writeBytecode(lua_State* lua, const void* data, size_t size, void* userData)
+{
+    Q_UNUSED(lua)
+
+    QByteArray* bytecode = static_cast<QByteArray*>(userData);
+    bytecode->append(static_cast<const char*>(data), static_cast<qsizetype>(size));
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+#ifndef LUABYTECODECOMPILER_H
+#define LUABYTECODECOMPILER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+
+#include <functional>
+
+extern "C"
+{
+#include <lua.h>
+}
+
+// Compiles lua scripts to bytecode files (.luac next to the script), which the game can load without parsing the source.
+// The bytecode is written by the vendored ldump.c, optionally without debug info (line numbers, local and upvalue names),
+// which makes the files smaller, but runtime errors then have no line anymore.
+// Compilation borrows its states from the LuaStatePool, so that several files can be compiled in parallel. At least one state is always
+// left to the syntax checks of the editor.
+class LuaBytecodeCompiler
+{
+public:
+    struct Result
+    {
+        QString filePathName;
+        QString bytecodeFilePathName;
+        bool success = false;
+        qint64 sourceSize = 0;
+        qint64 bytecodeSize = 0;
+        double compileTimeMs = 0.0; // Parsing and dumping, without reading and writing the files
+        QString message;
+    };
+public:
+    // Compiles the given code of the script, e.g. the content, which has just been saved
+    static Result compile(const QString& filePathName, const QByteArray& luaCode, bool stripDebugInfo);
+
+    // Reads the script from disk and compiles it
+    static Result compileFile(const QString& filePathName, bool stripDebugInfo);
+
+    // Compiles every .lua file below the folder in parallel on the global thread pool. Blocks until all files are done,
+    // resultCallback is called from the pool threads as soon as a file is done.
+    static QList<Result> compileFolder(const QString& folderPath, bool stripDebugInfo, const std::function<void(const Result&)>& resultCallback = Q_NULLPTR);
+
+    static QString getBytecodeFilePathName(const QString& filePathName);
+private:
+    static int writeBytecode(lua_State* lua, const void* data, size_t size, void* userData);
+};
+
+#endif // LUABYTECODECOMPILER_H
@@ -0,0 +1,507 @@
+#include "backend/luacheckcommand.h"
+#include "backend/luasyntaxchecker.h"
+#include "backend/luastatepool.h"
+#include "luascriptadapter.h"
+
+#include <QCommandLineParser>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QDebug>
+
+#include <cstdio>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace
+{
+    bool isIdentifierStart(QChar c)
+    {
+        return c.isLetter() || '_' == c;
+    }
+
+    bool isIdentifierChar(QChar c)
+    {
+        return c.isLetterOrNumber() || '_' == c;
+    }
+
+    int skipSpaces(const QString& line, int position)
+    {
+        while (position < line.size() && line[position].isSpace())
+        {
+            ++position;
+        }
+        return position;
+    }
+
+    // Replaces strings and comments of the line with spaces, so that they are not taken for code, the columns stay the same.
+    // Block comments may span lines, inBlockComment carries that over to the next line.
+    QString codeOfLine(const QString& line, bool& inBlockComment)
+    {
+        QString code = line;
+        int position = 0;
+
+        if (true == inBlockComment)
+        {
+            const int end = line.indexOf("]]");
+            if (-1 == end)
+            {
+                code.fill(' ');
+                return code;
+            }
+            code.replace(0, end + 2, QString(end + 2, ' '));
+            position = end + 2;
+            inBlockComment = false;
+        }
+
+        while (position < code.size())
+        {
+            const QChar c = code[position];
+
+            if ('"' == c || '\'' == c)
+            {
+                int end = position + 1;
+                while (end < code.size() && c != code[end])
+                {
+                    end += '\\' == code[end] ? 2 : 1;
+                }
+                end = qMin(end, static_cast<int>(code.size()) - 1);
+                code.replace(position, end - position + 1, QString(end - position + 1, ' '));
+                position = end + 1;
+            }
+            else if ('-' == c && position + 1 < code.size() && '-' == code[position + 1])
+            {
+                if (true == code.mid(position + 2, 2).startsWith("[["))
+                {
+                    const int end = code.indexOf("]]", position + 4);
+                    if (-1 == end)
+                    {
+                        inBlockComment = true;
+                        code.replace(position, code.size() - position, QString(code.size() - position, ' '));
+                        break;
+                    }
+                    code.replace(position, end + 2 - position, QString(end + 2 - position, ' '));
+                    position = end + 2;
+                }
+                else
+                {
+                    code.replace(position, code.size() - position, QString(code.size() - position, ' '));
+                    break;
+                }
+            }
+            else
+            {
+                ++position;
+            }
+        }
+
+        return code;
+    }
+}
+
+LuaCheckCommand::LuaCheckCommand()
+    : apiSnapshot(std::make_shared<const ApiSnapshot>()),
+    sandboxExecution(false)
+{
+
+}
+
+bool LuaCheckCommand::isRequested(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (0 == qstrcmp(argv[i], "--check"))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int LuaCheckCommand::run(const QStringList& arguments)
+{
+#ifdef Q_OS_WIN
+    // The executable is a gui application, the output only reaches the console, it has been started from, when attached to it
+    if (TRUE == AttachConsole(ATTACH_PARENT_PROCESS))
+    {
+        freopen("CONOUT$", "w", stdout);
+        freopen("CONOUT$", "w", stderr);
+    }
+#endif
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Checks every lua script below a folder and writes the diagnostics as json.");
+    parser.addHelpOption();
+
+    QCommandLineOption checkOption("check", "Folder, whose lua scripts are checked.", "folder");
+    QCommandLineOption apiOption("api", "Lua api file of NOWA-Engine, defaults to the one, last opened in the editor.", "file");
+    QCommandLineOption outputOption("output", "File, the json diagnostics are written to, defaults to the standard output.", "file");
+    QCommandLineOption threadsOption("threads", "Count of threads, defaults to the count of cores.", "count");
+    QCommandLineOption sandboxOption("sandbox", "Additionally executes each script, which compiles, in the bounded sandbox.");
+
+    parser.addOption(checkOption);
+    parser.addOption(apiOption);
+    parser.addOption(outputOption);
+    parser.addOption(threadsOption);
+    parser.addOption(sandboxOption);
+
+    parser.process(arguments);
+
+    const QString folderPath = parser.value(checkOption);
+
+    if (true == folderPath.isEmpty() || false == QFileInfo(folderPath).isDir())
+    {
+        fprintf(stderr, "Folder to check does not exist: %s\n", qPrintable(folderPath));
+        return 2;
+    }
+
+    QString apiFilePathName = parser.value(apiOption);
+
+    if (true == apiFilePathName.isEmpty())
+    {
+        QSettings settings("NOWA", "NOWALuaScript");
+        apiFilePathName = settings.value("LuaApiFilePath", QString()).toString();
+    }
+
+    if (false == apiFilePathName.isEmpty())
+    {
+        QMap<QString, LuaScriptAdapter::ClassData> apiData;
+        QString message;
+        if (false == LuaScriptAdapter::parseLuaApi(apiFilePathName, apiData, message))
+        {
+            // Without api, only the syntax is checked
+            fprintf(stderr, "%s\n", qPrintable(message));
+        }
+        else
+        {
+            this->apiSnapshot = std::make_shared<const ApiSnapshot>(apiData);
+        }
+    }
+
+    this->sandboxExecution = parser.isSet(sandboxOption);
+
+    QStringList filePathNames;
+
+    QDirIterator it(folderPath, QStringList() << "*.lua", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        filePathNames.append(it.next());
+    }
+
+    QThreadPool threadPool;
+
+    const int threadCount = parser.value(threadsOption).toInt();
+    if (threadCount > 0)
+    {
+        threadPool.setMaxThreadCount(threadCount);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Each file is checked in a pooled state, the pool bounds the count of files checked at the same time
+    const QList<QList<Diagnostic>> fileDiagnostics = QtConcurrent::blockingMapped<QList<QList<Diagnostic>>>(&threadPool, filePathNames, [this](const QString& filePathName)
+        {
+            return this->checkFile(filePathName);
+        });
+
+    QList<Diagnostic> diagnostics;
+    for (const QList<Diagnostic>& currentDiagnostics : fileDiagnostics)
+    {
+        diagnostics.append(currentDiagnostics);
+    }
+
+    const QByteArray json = this->toJson(diagnostics, filePathNames.size(), timer.elapsed());
+
+    const QString outputFilePathName = parser.value(outputOption);
+
+    if (true == outputFilePathName.isEmpty())
+    {
+        fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+        fflush(stdout);
+    }
+    else
+    {
+        QFile file(outputFilePathName);
+
+        if (false == file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            fprintf(stderr, "Failed to write diagnostics file: %s Error: %s\n", qPrintable(outputFilePathName), qPrintable(file.errorString()));
+            return 2;
+        }
+
+        file.write(json);
+        file.close();
+    }
+
+    for (const Diagnostic& diagnostic : std::as_const(diagnostics))
+    {
+        if ("error" == diagnostic.severity)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+QList<LuaCheckCommand::Diagnostic> LuaCheckCommand::checkFile(const QString& filePathName) const
+{
+    QList<Diagnostic> diagnostics;
+
+    QFile file(filePathName);
+
+    if (false == file.open(QIODevice::ReadOnly))
+    {
+        Diagnostic diagnostic;
+        diagnostic.filePathName = filePathName;
+        diagnostic.severity = "error";
+        diagnostic.message = "Unable to open file: " + file.errorString();
+        diagnostics.append(diagnostic);
+        return diagnostics;
+    }
+
+    const QString luaCode = QString::fromUtf8(file.readAll());
+    file.close();
+
+    // The same checker, the editor uses. One per thread, so that its buffers are reused from file to file
+    thread_local LuaSyntaxChecker luaSyntaxChecker;
+    luaSyntaxChecker.setSandboxExecution(this->sandboxExecution);
+
+    lua_State* lua = LuaStatePool::instance()->acquire();
+    if (Q_NULLPTR == lua)
+    {
+        Diagnostic diagnostic;
+        diagnostic.filePathName = filePathName;
+        diagnostic.severity = "error";
+        diagnostic.message = "No lua state available for checking.";
+        diagnostics.append(diagnostic);
+        return diagnostics;
+    }
+
+    const LuaSyntaxChecker::Result result = luaSyntaxChecker.check(lua, luaCode, QFileInfo(filePathName).fileName());
+
+    LuaStatePool::instance()->release(lua);
+
+    for (const LuaSyntaxChecker::Error& error : result.errors)
+    {
+        Diagnostic diagnostic;
+        diagnostic.filePathName = filePathName;
+        diagnostic.line = error.line;
+        diagnostic.start = error.start;
+        diagnostic.end = error.end;
+        diagnostic.severity = "error";
+        diagnostic.message = error.message;
+        diagnostics.append(diagnostic);
+    }
+
+    // Types can only be followed in code, which compiles
+    if (true == result.valid && this->apiSnapshot->getClassCount() > 0)
+    {
+        this->checkApiCalls(filePathName, luaCode, diagnostics);
+    }
+
+    return diagnostics;
+}
+
+void LuaCheckCommand::checkApiCalls(const QString& filePathName, const QString& luaCode, QList<Diagnostic>& diagnostics) const
+{
+    // Types of the variables, as far as they are known from assignments of method chains, e.g. "local controller = AppStateManager:getGameObjectController()"
+    QHash<QString, QString> variableTypes;
+
+    static const QRegularExpression assignmentRegex(R"(^\s*(?:local\s+)?(\w+)\s*=\s*(\w+)\s*:)");
+
+    const QStringList lines = luaCode.split('\n');
+    bool inBlockComment = false;
+
+    for (int lineIndex = 0; lineIndex < lines.size(); ++lineIndex)
+    {
+        const QString code = codeOfLine(lines[lineIndex], inBlockComment);
+
+        const QRegularExpressionMatch assignmentMatch = assignmentRegex.match(code);
+
+        const QString chainType = this->checkChains(filePathName, lineIndex + 1, code, 0, code.size(), assignmentMatch.capturedStart(2), variableTypes, diagnostics);
+
+        if (true == assignmentMatch.hasMatch())
+        {
+            // A variable, which is assigned something unknown, loses its type
+            if (true == chainType.isEmpty())
+            {
+                variableTypes.remove(assignmentMatch.captured(1));
+            }
+            else
+            {
+                variableTypes[assignmentMatch.captured(1)] = chainType;
+            }
+        }
+    }
+}
+
+QString LuaCheckCommand::checkChains(const QString& filePathName, int line, const QString& code, int from, int to, int assignmentStart,
+                                     const QHash<QString, QString>& variableTypes, QList<Diagnostic>& diagnostics) const
+{
+    QString assignmentType;
+    int position = from;
+
+    while (position < to)
+    {
+        if (false == isIdentifierStart(code[position]) || (position > 0 && (true == isIdentifierChar(code[position - 1]) || '.' == code[position - 1] || ':' == code[position - 1])))
+        {
+            ++position;
+            continue;
+        }
+
+        const int nameStart = position;
+        while (position < to && true == isIdentifierChar(code[position]))
+        {
+            ++position;
+        }
+
+        const QString name = code.mid(nameStart, position - nameStart);
+
+        QString type = variableTypes.value(name);
+        if (true == type.isEmpty() && true == this->apiSnapshot->isValidClassName(name))
+        {
+            // Singletons are used by their class name, e.g. AppStateManager
+            type = name;
+        }
+
+        // Follows the chain as long as the types are known
+        while (false == type.isEmpty())
+        {
+            int next = skipSpaces(code, position);
+            if (next >= to || ':' != code[next])
+            {
+                break;
+            }
+
+            next = skipSpaces(code, next + 1);
+            const int methodStart = next;
+            while (next < to && true == isIdentifierChar(code[next]))
+            {
+                ++next;
+            }
+
+            const QString methodName = code.mid(methodStart, next - methodStart);
+            if (true == methodName.isEmpty())
+            {
+                type.clear();
+                break;
+            }
+
+            position = next;
+
+            // Constants are members of the class as well, like in the parsed map
+            const ApiSnapshot::MethodRecord* methodRecord = this->apiSnapshot->findMethod(type, methodName);
+            if (Q_NULLPTR == methodRecord)
+            {
+                methodRecord = this->apiSnapshot->findConstant(type, methodName);
+            }
+
+            if (Q_NULLPTR == methodRecord)
+            {
+                Diagnostic diagnostic;
+                diagnostic.filePathName = filePathName;
+                diagnostic.line = line;
+                diagnostic.start = methodStart;
+                diagnostic.end = next;
+                diagnostic.severity = "warning";
+                diagnostic.message = QString("%1:%2: class '%3' has no method '%4'").arg(QFileInfo(filePathName).fileName()).arg(line).arg(type, methodName);
+                diagnostics.append(diagnostic);
+
+                type.clear();
+                break;
+            }
+
+            // The arguments may contain further chains, they are checked on their own
+            next = skipSpaces(code, next);
+            if (next < to && '(' == code[next])
+            {
+                int depth = 0;
+                int end = next;
+                for (; end < to; ++end)
+                {
+                    if ('(' == code[end])
+                    {
+                        ++depth;
+                    }
+                    else if (')' == code[end] && 0 == --depth)
+                    {
+                        break;
+                    }
+                }
+
+                this->checkChains(filePathName, line, code, next + 1, end, -1, variableTypes, diagnostics);
+
+                if (end >= to)
+                {
+                    // The call spans lines, the type is lost
+                    position = to;
+                    type.clear();
+                    break;
+                }
+
+                position = end + 1;
+            }
+
+            const QString returns = methodRecord->returns;
+            type = true == this->apiSnapshot->isValidClassName(returns) ? returns : QString();
+        }
+
+        if (nameStart == assignmentStart)
+        {
+            assignmentType = type;
+        }
+    }
+
+    return assignmentType;
+}
+
+QByteArray LuaCheckCommand::toJson(const QList<Diagnostic>& diagnostics, int fileCount, qint64 elapsedMs) const
+{
+    QJsonArray diagnosticArray;
+    int errorCount = 0;
+    int warningCount = 0;
+
+    for (const Diagnostic& diagnostic : diagnostics)
+    {
+        QJsonObject diagnosticObject;
+        diagnosticObject["file"] = diagnostic.filePathName;
+        diagnosticObject["line"] = diagnostic.line;
+        diagnosticObject["startColumn"] = diagnostic.start;
+        diagnosticObject["endColumn"] = diagnostic.end;
+        diagnosticObject["severity"] = diagnostic.severity;
+        diagnosticObject["message"] = diagnostic.message;
+        diagnosticArray.append(diagnosticObject);
+
+        if ("error" == diagnostic.severity)
+        {
+            ++errorCount;
+        }
+        else
+        {
+            ++warningCount;
+        }
+    }
+
+    QJsonObject root;
+    root["files"] = fileCount;
+    root["errors"] = errorCount;
+    root["warnings"] = warningCount;
+    root["elapsedMs"] = elapsedMs;
+    root["apiClasses"] = this->apiSnapshot->getClassCount();
+    root["diagnostics"] = diagnosticArray;
+
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
@@ -0,0 +1,54 @@
+#ifndef LUACHECKCOMMAND_H
+#define LUACHECKCOMMAND_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include <QHash>
+
+#include <memory>
+
+#include "model/apisnapshot.h"
+
+// Headless mode of the executable, which checks every .lua file below a folder without gui, e.g. before a build:
+// NOWALuaScript --check <folder> [--api <NOWA_Api.lua>] [--output <diagnostics.json>] [--threads <count>] [--sandbox]
+// Each file is checked like in the editor by the LuaSyntaxChecker on a pooled lua state. With the lua api of NOWA-Engine,
+// calls of methods, which the class of the object does not have, are reported as warnings.
+// The diagnostics are written as json, the exit code is 1, if there is any error.
+class LuaCheckCommand
+{
+public:
+    struct Diagnostic
+    {
+        QString filePathName;
+        int line = -1;
+        int start = 0; // Columns, 0 and 0 if only the line is known
+        int end = 0;
+        QString severity; // "error" or "warning"
+        QString message;
+    };
+public:
+    LuaCheckCommand();
+
+    static bool isRequested(int argc, char* argv[]);
+
+    // Runs the check with the arguments of the application and returns the exit code
+    int run(const QStringList& arguments);
+private:
+    QList<Diagnostic> checkFile(const QString& filePathName) const;
+
+    // Follows method chains like "AppStateManager:getGameObjectController():getGameObjectFromId(id)" through the api
+    void checkApiCalls(const QString& filePathName, const QString& luaCode, QList<Diagnostic>& diagnostics) const;
+
+    // Checks the chains between the columns from and to of the line. Returns the type of the chain, which starts at assignmentStart.
+    QString checkChains(const QString& filePathName, int line, const QString& code, int from, int to, int assignmentStart,
+                        const QHash<QString, QString>& variableTypes, QList<Diagnostic>& diagnostics) const;
+
+    QByteArray toJson(const QList<Diagnostic>& diagnostics, int fileCount, qint64 elapsedMs) const;
+private:
+    std::shared_ptr<const ApiSnapshot> apiSnapshot; // Queried by all check threads at once
+    bool sandboxExecution;
+};
+
+#endif // LUACHECKCOMMAND_H
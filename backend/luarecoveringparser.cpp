@@ -0,0 +1,1217 @@
+#include "backend/luarecoveringparser.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+extern "C"
+{
+#include <lobject.h>
+#include <lstate.h>
+#include <lzio.h>
+#include <llex.h>
+#include <lparser.h>
+}
+
+namespace
+{
+    // Stands for the text, the lexer could not read, e.g. an unfinished string. The parser treats it like a literal.
+    const int lexErrorToken = -2;
+
+    // The limit of the lua parser, which NOWA_LUA_DEFINITIONS may change, so that both report too deep nesting alike
+    const int maxSyntaxLevels = LUAI_MAXCCALLS;
+
+    struct RawToken
+    {
+        int type;
+        int start;
+        int end;
+    };
+
+    // One run of the lexer. After a lexer error, lexing restarts behind the error with a new run.
+    // Only plain data is used here, because lexer errors are thrown with longjmp, which does not unwind c++ objects.
+    struct LexerRun
+    {
+        const char* data = Q_NULLPTR;
+        size_t size = 0;
+        size_t startOffset = 0;
+        int startLine = 1;
+        const char* chunkName = Q_NULLPTR;
+        bool delivered = false;
+        LexState* lexState = Q_NULLPTR;
+        ZIO* zio = Q_NULLPTR;
+        Mbuffer* buffer = Q_NULLPTR;
+        FuncState* funcState = Q_NULLPTR;
+        size_t tokenStart = 0;
+        QVector<RawToken>* rawTokens = Q_NULLPTR;
+    };
+
+    const char* readRun(lua_State* lua, void* userData, size_t* size)
+    {
+        Q_UNUSED(lua)
+
+        LexerRun* run = static_cast<LexerRun*>(userData);
+
+        if (true == run->delivered || run->startOffset >= run->size)
+        {
+            *size = 0;
+            return Q_NULLPTR;
+        }
+
+        // The whole code is one block, so that the position of the lexer is a plain pointer difference
+        run->delivered = true;
+        *size = run->size - run->startOffset;
+        return run->data + run->startOffset;
+    }
+
+    // Byte offset of the character, the lexer looks at
+    size_t currentOffset(const LexerRun* run)
+    {
+        if (EOZ == run->lexState->current)
+        {
+            return run->size;
+        }
+        return static_cast<size_t>(run->lexState->z->p - run->data) - 1;
+    }
+
+    void advance(LexerRun* run)
+    {
+        run->lexState->current = zgetc(run->lexState->z);
+    }
+
+    // Level of a long bracket like "[==[" at the offset, -1 if there is none
+    int longBracketLevel(const LexerRun* run, size_t offset)
+    {
+        int level = 0;
+        size_t position = offset + 1;
+
+        while (position < run->size && '=' == run->data[position])
+        {
+            ++level;
+            ++position;
+        }
+        return (position < run->size && '[' == run->data[position]) ? level : -1;
+    }
+
+    // Skips whitespace and comments like llex does, so that the lexer is at the first character of the next token afterwards
+    // and the start offset of each token is known
+    void skipBlanks(LexerRun* run)
+    {
+        LexState* lexState = run->lexState;
+
+        for (;;)
+        {
+            const int c = lexState->current;
+
+            if ('\n' == c || '\r' == c)
+            {
+                advance(run);
+                // "\n\r" or "\r\n" is one line break
+                if (('\n' == lexState->current || '\r' == lexState->current) && c != lexState->current)
+                {
+                    advance(run);
+                }
+                ++lexState->linenumber;
+            }
+            else if (EOZ != c && 0 != isspace(c))
+            {
+                advance(run);
+            }
+            else if ('-' == c && currentOffset(run) + 1 < run->size && '-' == run->data[currentOffset(run) + 1])
+            {
+                const size_t commentStart = currentOffset(run);
+                advance(run);
+                advance(run);
+
+                const int level = '[' == lexState->current ? longBracketLevel(run, currentOffset(run)) : -1;
+
+                if (level >= 0)
+                {
+                    // Long comment, ends with "]", the same count of "=" and "]"
+                    const size_t bodyStart = currentOffset(run) + level + 2;
+                    size_t commentEnd = run->size;
+
+                    for (size_t position = bodyStart; position < run->size; ++position)
+                    {
+                        if (']' != run->data[position])
+                        {
+                            continue;
+                        }
+
+                        size_t closing = position + 1;
+                        while (closing < run->size && '=' == run->data[closing])
+                        {
+                            ++closing;
+                        }
+
+                        if (static_cast<int>(closing - position - 1) == level && closing < run->size && ']' == run->data[closing])
+                        {
+                            commentEnd = closing + 1;
+                            break;
+                        }
+                    }
+
+                    if (run->size == commentEnd)
+                    {
+                        // Everything up to the end is comment, the next run has nothing to lex anymore
+                        run->tokenStart = commentStart;
+                        while (EOZ != lexState->current)
+                        {
+                            advance(run);
+                        }
+                        luaX_lexerror(lexState, "unfinished long comment", TK_EOS);
+                    }
+
+                    while (EOZ != lexState->current && currentOffset(run) < commentEnd)
+                    {
+                        if ('\n' == lexState->current)
+                        {
+                            ++lexState->linenumber;
+                        }
+                        advance(run);
+                    }
+                }
+                else
+                {
+                    // Short comment up to the end of the line
+                    while (EOZ != lexState->current && '\n' != lexState->current && '\r' != lexState->current)
+                    {
+                        advance(run);
+                    }
+                }
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    int lexAll(lua_State* lua)
+    {
+        LexerRun* run = static_cast<LexerRun*>(lua_touserdata(lua, 1));
+
+        // The lexer keeps its strings in the table of the function state being parsed, see luaX_newstring. The stack anchors both for the gc.
+        lua_newtable(lua);
+        run->funcState->h = hvalue(lua->top - 1);
+
+        lua_pushstring(lua, run->chunkName);
+        TString* source = rawtsvalue(lua->top - 1);
+
+        luaZ_init(lua, run->zio, &readRun, run);
+
+        LexState* lexState = run->lexState;
+        lexState->buff = run->buffer;
+        luaX_setinput(lua, lexState, run->zio, source);
+        lexState->fs = run->funcState;
+        lexState->linenumber = run->startLine;
+
+        for (;;)
+        {
+            skipBlanks(run);
+            run->tokenStart = currentOffset(run);
+
+            luaX_next(lexState);
+
+            const RawToken rawToken = { lexState->t.token, static_cast<int>(run->tokenStart), static_cast<int>(currentOffset(run)) };
+            run->rawTokens->append(rawToken);
+
+            if (TK_EOS == lexState->t.token)
+            {
+                break;
+            }
+        }
+
+        return 0;
+    }
+
+    // Binary operators with their left and right priority, like in lparser.c
+    bool binaryPriority(int token, int& left, int& right)
+    {
+        switch (token)
+        {
+        case '+': case '-':
+            left = 6; right = 6; return true;
+        case '*': case '/': case '%':
+            left = 7; right = 7; return true;
+        case '^':
+            left = 10; right = 9; return true; // Right associative
+        case TK_CONCAT:
+            left = 5; right = 4; return true; // Right associative
+        case TK_EQ: case TK_NE: case '<': case TK_LE: case '>': case TK_GE:
+            left = 3; right = 3; return true;
+        case TK_AND:
+            left = 2; right = 2; return true;
+        case TK_OR:
+            left = 1; right = 1; return true;
+        default:
+            return false;
+        }
+    }
+
+    const int unaryPriority = 8;
+}
+
+LuaRecoveringParser::LuaRecoveringParser()
+    : data(Q_NULLPTR),
+    size(0),
+    position(0),
+    panic(false),
+    level(0)
+{
+
+}
+
+QList<LuaSyntaxChecker::Error> LuaRecoveringParser::parse(lua_State* lua, const char* data, size_t size, const QString& chunkName)
+{
+    this->data = data;
+    this->size = size;
+    this->chunkName = chunkName;
+    this->tokens.clear();
+    this->errors.clear();
+    this->closers.clear();
+    this->functions.clear();
+    this->position = 0;
+    this->panic = false;
+    this->level = 0;
+
+    this->lineStarts.clear();
+    this->lineStarts.append(0);
+    for (size_t i = 0; i < size; ++i)
+    {
+        if ('\n' == data[i])
+        {
+            this->lineStarts.append(static_cast<int>(i + 1));
+        }
+    }
+
+    this->tokenize(lua);
+
+    // The main chunk is a vararg function, which must end with the end of the code
+    FunctionContext mainFunction;
+    mainFunction.vararg = true;
+    this->functions.append(mainFunction);
+
+    Closer closer;
+    closer.what = TK_EOS;
+    this->closers.append(closer);
+
+    while (true)
+    {
+        this->block();
+
+        if (TK_EOS == this->current().type)
+        {
+            break;
+        }
+
+        // E.g. an 'end' too many, report it and go on with the rest of the code
+        this->errorExpected(TK_EOS);
+        this->next();
+    }
+
+    return this->errors;
+}
+
+void LuaRecoveringParser::tokenize(lua_State* lua)
+{
+    QVector<RawToken> rawTokens;
+
+    const QByteArray chunkNameUtf8 = "=" + this->chunkName.toUtf8();
+
+    size_t startOffset = 0;
+
+    while (true)
+    {
+        // Owned here and not by the protected call, so that the position of the lexer can still be read after an error
+        LexState lexState;
+        ZIO zio;
+        Mbuffer buffer;
+        FuncState funcState;
+        std::memset(&lexState, 0, sizeof(lexState));
+        std::memset(&funcState, 0, sizeof(funcState));
+        luaZ_initbuffer(lua, &buffer);
+
+        LexerRun run;
+        run.data = this->data;
+        run.size = this->size;
+        run.startOffset = startOffset;
+        run.startLine = this->lineOf(static_cast<int>(startOffset));
+        run.chunkName = chunkNameUtf8.constData();
+        run.lexState = &lexState;
+        run.zio = &zio;
+        run.buffer = &buffer;
+        run.funcState = &funcState;
+        run.rawTokens = &rawTokens;
+
+        const int result = lua_cpcall(lua, &lexAll, &run);
+
+        size_t errorEnd = run.size;
+
+        if (0 != result)
+        {
+            // The lexer stopped with e.g. "unfinished string", the rest of the code is lexed with the next run
+            const QString message = QString::fromUtf8(lua_tostring(lua, -1));
+            lua_pop(lua, 1);
+
+            errorEnd = qMax(currentOffset(&run), run.tokenStart + 1);
+
+            Token token;
+            token.type = lexErrorToken;
+            token.start = static_cast<int>(run.tokenStart);
+            token.end = static_cast<int>(qMin(errorEnd, run.size));
+            token.line = this->lineOf(token.start);
+            this->addError(token, message);
+
+            const RawToken rawToken = { lexErrorToken, token.start, token.end };
+            rawTokens.append(rawToken);
+        }
+
+        luaZ_freebuffer(lua, &buffer);
+
+        if (0 == result || errorEnd >= this->size)
+        {
+            break;
+        }
+
+        startOffset = errorEnd;
+    }
+
+    for (const RawToken& rawToken : rawTokens)
+    {
+        // The eof token is added once at the end
+        if (TK_EOS == rawToken.type)
+        {
+            continue;
+        }
+
+        Token token;
+        token.type = rawToken.type;
+        token.start = rawToken.start;
+        token.end = rawToken.end;
+        token.line = this->lineOf(token.start);
+        this->tokens.append(token);
+    }
+
+    Token eof;
+    eof.type = TK_EOS;
+    eof.start = static_cast<int>(this->size);
+    eof.end = static_cast<int>(this->size);
+    eof.line = this->lineOf(eof.start);
+    this->tokens.append(eof);
+}
+
+int LuaRecoveringParser::lineOf(int offset) const
+{
+    // Lines are 1-based like in lua
+    return static_cast<int>(std::upper_bound(this->lineStarts.constBegin(), this->lineStarts.constEnd(), offset) - this->lineStarts.constBegin());
+}
+
+int LuaRecoveringParser::columnOf(int offset, int line) const
+{
+    // Columns are counted in utf16 code units like in the QTextDocument of the editor
+    const int lineStart = this->lineStarts.at(line - 1);
+    return QString::fromUtf8(this->data + lineStart, offset - lineStart).size();
+}
+
+const LuaRecoveringParser::Token& LuaRecoveringParser::current(void) const
+{
+    return this->tokens.at(this->position);
+}
+
+const LuaRecoveringParser::Token& LuaRecoveringParser::lookahead(void) const
+{
+    return this->tokens.at(qMin(this->position + 1, static_cast<int>(this->tokens.size()) - 1));
+}
+
+void LuaRecoveringParser::next(void)
+{
+    if (this->position < this->tokens.size() - 1)
+    {
+        ++this->position;
+    }
+}
+
+bool LuaRecoveringParser::testNext(int token)
+{
+    if (token == this->current().type)
+    {
+        this->next();
+        return true;
+    }
+    return false;
+}
+
+void LuaRecoveringParser::check(int token)
+{
+    if (token != this->current().type)
+    {
+        this->errorExpected(token);
+    }
+}
+
+void LuaRecoveringParser::checkNext(int token)
+{
+    // A missing token is only reported, the parser goes on, as if it had been there
+    if (token == this->current().type)
+    {
+        this->next();
+    }
+    else
+    {
+        this->errorExpected(token);
+    }
+}
+
+void LuaRecoveringParser::checkMatch(int what, int who, int line)
+{
+    if (false == this->testNext(what))
+    {
+        if (line == this->current().line)
+        {
+            this->errorExpected(what);
+        }
+        else
+        {
+            this->syntaxError(QString("'%1' expected (to close '%2' at line %3)").arg(this->tokenToString(what), this->tokenToString(who), QString::number(line)));
+        }
+    }
+}
+
+void LuaRecoveringParser::checkName(void)
+{
+    this->checkNext(TK_NAME);
+}
+
+void LuaRecoveringParser::syntaxError(const QString& message)
+{
+    if (true == this->panic)
+    {
+        return;
+    }
+
+    const Token& token = this->current();
+
+    // Same format as the messages of luac, e.g. "Scene1_barrel_0.lua:12: 'end' expected near 'local'"
+    this->addError(token, QString("%1:%2: %3 near '%4'").arg(this->chunkName, QString::number(token.line), message, this->tokenText(token)));
+    this->panic = true;
+}
+
+void LuaRecoveringParser::errorExpected(int token)
+{
+    this->syntaxError(QString("'%1' expected").arg(this->tokenToString(token)));
+}
+
+void LuaRecoveringParser::addError(const Token& token, const QString& message)
+{
+    // The first error of a line is enough, more would just be consequences of it
+    if (false == this->errors.isEmpty() && this->errors.last().line == token.line)
+    {
+        return;
+    }
+
+    LuaSyntaxChecker::Error error;
+    error.line = token.line;
+    error.start = this->columnOf(token.start, token.line);
+
+    // A token, which spans several lines, is marked up to the end of its first line
+    const int lineEnd = token.line < this->lineStarts.size() ? this->lineStarts.at(token.line) - 1 : static_cast<int>(this->size);
+    error.end = this->columnOf(qMin(token.end, lineEnd), token.line);
+    error.message = message;
+
+    this->errors.append(error);
+}
+
+QString LuaRecoveringParser::tokenToString(int token) const
+{
+    if (token >= FIRST_RESERVED)
+    {
+        return QString::fromUtf8(luaX_tokens[token - FIRST_RESERVED]);
+    }
+    if (lexErrorToken == token)
+    {
+        return "?";
+    }
+    return QString(QChar(token));
+}
+
+QString LuaRecoveringParser::tokenText(const Token& token) const
+{
+    if (TK_EOS == token.type)
+    {
+        return this->tokenToString(TK_EOS);
+    }
+    return QString::fromUtf8(this->data + token.start, token.end - token.start);
+}
+
+bool LuaRecoveringParser::blockFollow(int token) const
+{
+    switch (token)
+    {
+    case TK_ELSE: case TK_ELSEIF: case TK_END: case TK_UNTIL: case TK_EOS:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool LuaRecoveringParser::isSynchronizationPoint(void) const
+{
+    switch (this->current().type)
+    {
+    case TK_LOCAL: case TK_IF: case TK_WHILE: case TK_FOR: case TK_REPEAT: case TK_DO: case TK_RETURN: case TK_BREAK:
+        return true;
+    case TK_FUNCTION:
+        // A function statement, not an anonymous function within an expression
+        return TK_NAME == this->lookahead().type;
+    default:
+        return this->blockFollow(this->current().type);
+    }
+}
+
+void LuaRecoveringParser::synchronize(void)
+{
+    // Skips the rest of the broken statement. Blocks of anonymous functions and brackets within the skipped part are skipped as a whole.
+    int blockDepth = 0;
+    int bracketDepth = 0;
+
+    while (TK_EOS != this->current().type)
+    {
+        const Token& token = this->current();
+
+        if (0 == blockDepth)
+        {
+            if (true == this->isSynchronizationPoint())
+            {
+                break;
+            }
+
+            // A name at the beginning of a line usually starts the next statement
+            if (0 == bracketDepth && TK_NAME == token.type && this->position > 0 && this->tokens.at(this->position - 1).line < token.line)
+            {
+                break;
+            }
+        }
+
+        switch (token.type)
+        {
+        case TK_FUNCTION: case TK_IF: case TK_DO: case TK_REPEAT:
+            ++blockDepth;
+            break;
+        case TK_END: case TK_UNTIL:
+            --blockDepth;
+            break;
+        case '(': case '{': case '[':
+            ++bracketDepth;
+            break;
+        case ')': case '}': case ']':
+            bracketDepth = qMax(0, bracketDepth - 1);
+            break;
+        default:
+            break;
+        }
+
+        this->next();
+    }
+
+    this->panic = false;
+}
+
+void LuaRecoveringParser::block(void)
+{
+    // A block is a new start, an error in the head of the enclosing statement does not hide the errors within the block
+    this->panic = false;
+
+    bool lastStatement = false;
+
+    while (false == this->blockFollow(this->current().type))
+    {
+        const int startPosition = this->position;
+
+        if (true == lastStatement)
+        {
+            // 'return' and 'break' must be the last statement of a block, the enclosing construct reports, what it expected instead
+            const Closer& closer = this->closers.last();
+            if (TK_EOS == closer.what)
+            {
+                this->errorExpected(TK_EOS);
+            }
+            else
+            {
+                this->checkMatch(closer.what, closer.who, closer.line);
+            }
+            this->synchronize();
+            lastStatement = false;
+            continue;
+        }
+
+        lastStatement = this->statement();
+        this->testNext(';');
+
+        if (true == this->panic)
+        {
+            this->synchronize();
+        }
+
+        // Each round must consume something
+        if (startPosition == this->position && false == this->blockFollow(this->current().type))
+        {
+            this->next();
+        }
+    }
+}
+
+bool LuaRecoveringParser::statement(void)
+{
+    const int line = this->current().line;
+
+    if (++this->level > maxSyntaxLevels)
+    {
+        this->syntaxError("chunk has too many syntax levels");
+        --this->level;
+        return false;
+    }
+
+    bool lastStatement = false;
+
+    switch (this->current().type)
+    {
+    case TK_IF:
+        this->ifStatement(line);
+        break;
+    case TK_WHILE:
+        this->whileStatement(line);
+        break;
+    case TK_DO:
+        this->doStatement(line);
+        break;
+    case TK_FOR:
+        this->forStatement(line);
+        break;
+    case TK_REPEAT:
+        this->repeatStatement(line);
+        break;
+    case TK_FUNCTION:
+        this->functionStatement(line);
+        break;
+    case TK_LOCAL:
+        this->next();
+        if (true == this->testNext(TK_FUNCTION))
+        {
+            this->localFunction(line);
+        }
+        else
+        {
+            this->localStatement();
+        }
+        break;
+    case TK_RETURN:
+        this->next();
+        this->returnStatement();
+        lastStatement = true;
+        break;
+    case TK_BREAK:
+        this->next();
+        this->breakStatement();
+        lastStatement = true;
+        break;
+    default:
+        this->expressionStatement();
+        break;
+    }
+
+    --this->level;
+    return lastStatement;
+}
+
+void LuaRecoveringParser::ifStatement(int line)
+{
+    // if cond then block {elseif cond then block} [else block] end
+    Closer closer;
+    closer.what = TK_END;
+    closer.who = TK_IF;
+    closer.line = line;
+    this->closers.append(closer);
+
+    this->testThenBlock();
+
+    while (TK_ELSEIF == this->current().type)
+    {
+        this->testThenBlock();
+    }
+
+    if (true == this->testNext(TK_ELSE))
+    {
+        this->block();
+    }
+
+    this->closers.removeLast();
+    this->checkMatch(TK_END, TK_IF, line);
+}
+
+void LuaRecoveringParser::testThenBlock(void)
+{
+    this->next(); // Skip 'if' or 'elseif'
+    this->expression();
+    this->checkNext(TK_THEN);
+    this->block();
+}
+
+void LuaRecoveringParser::whileStatement(int line)
+{
+    this->next();
+    this->expression();
+    this->checkNext(TK_DO);
+
+    Closer closer;
+    closer.what = TK_END;
+    closer.who = TK_WHILE;
+    closer.line = line;
+    this->closers.append(closer);
+
+    ++this->functions.last().loopDepth;
+    this->block();
+    --this->functions.last().loopDepth;
+
+    this->closers.removeLast();
+    this->checkMatch(TK_END, TK_WHILE, line);
+}
+
+void LuaRecoveringParser::doStatement(int line)
+{
+    this->next();
+
+    Closer closer;
+    closer.what = TK_END;
+    closer.who = TK_DO;
+    closer.line = line;
+    this->closers.append(closer);
+
+    this->block();
+
+    this->closers.removeLast();
+    this->checkMatch(TK_END, TK_DO, line);
+}
+
+void LuaRecoveringParser::forStatement(int line)
+{
+    // for Name = exp, exp [, exp] do block end, or for Name {, Name} in explist do block end
+    this->next();
+    this->checkName();
+
+    switch (this->current().type)
+    {
+    case '=':
+        this->next();
+        this->expression();
+        this->checkNext(',');
+        this->expression();
+        if (true == this->testNext(','))
+        {
+            this->expression();
+        }
+        break;
+    case ',': case TK_IN:
+        while (true == this->testNext(','))
+        {
+            this->checkName();
+        }
+        this->checkNext(TK_IN);
+        this->expressionList();
+        break;
+    default:
+        this->syntaxError("'=' or 'in' expected");
+        break;
+    }
+
+    Closer closer;
+    closer.what = TK_END;
+    closer.who = TK_FOR;
+    closer.line = line;
+    this->closers.append(closer);
+
+    this->forBody();
+
+    this->closers.removeLast();
+    this->checkMatch(TK_END, TK_FOR, line);
+}
+
+void LuaRecoveringParser::forBody(void)
+{
+    this->checkNext(TK_DO);
+
+    ++this->functions.last().loopDepth;
+    this->block();
+    --this->functions.last().loopDepth;
+}
+
+void LuaRecoveringParser::repeatStatement(int line)
+{
+    this->next();
+
+    Closer closer;
+    closer.what = TK_UNTIL;
+    closer.who = TK_REPEAT;
+    closer.line = line;
+    this->closers.append(closer);
+
+    ++this->functions.last().loopDepth;
+    this->block();
+    --this->functions.last().loopDepth;
+
+    this->closers.removeLast();
+    this->checkMatch(TK_UNTIL, TK_REPEAT, line);
+    this->expression();
+}
+
+void LuaRecoveringParser::functionStatement(int line)
+{
+    // function Name {'.' Name} [':' Name] body
+    this->next();
+    this->checkName();
+
+    while (true == this->testNext('.'))
+    {
+        this->checkName();
+    }
+
+    bool needSelf = false;
+    if (true == this->testNext(':'))
+    {
+        this->checkName();
+        needSelf = true;
+    }
+
+    this->body(needSelf, line);
+}
+
+void LuaRecoveringParser::localFunction(int line)
+{
+    this->checkName();
+    this->body(false, line);
+}
+
+void LuaRecoveringParser::localStatement(void)
+{
+    // local Name {',' Name} ['=' explist]
+    do
+    {
+        this->checkName();
+    } while (false == this->panic && true == this->testNext(','));
+
+    if (true == this->testNext('='))
+    {
+        this->expressionList();
+    }
+}
+
+void LuaRecoveringParser::returnStatement(void)
+{
+    if (true == this->blockFollow(this->current().type) || ';' == this->current().type)
+    {
+        return;
+    }
+    this->expressionList();
+}
+
+void LuaRecoveringParser::breakStatement(void)
+{
+    if (0 == this->functions.last().loopDepth)
+    {
+        this->syntaxError("no loop to break");
+    }
+}
+
+void LuaRecoveringParser::expressionStatement(void)
+{
+    // A statement is either a function call or an assignment
+    const ExpressionKind kind = this->primaryExpression();
+
+    if (Call != kind)
+    {
+        this->assignment(kind);
+    }
+}
+
+void LuaRecoveringParser::assignment(ExpressionKind kind)
+{
+    if (Variable != kind)
+    {
+        this->syntaxError("syntax error");
+    }
+
+    if (true == this->testNext(','))
+    {
+        this->assignment(this->primaryExpression());
+    }
+    else
+    {
+        this->checkNext('=');
+        this->expressionList();
+    }
+}
+
+void LuaRecoveringParser::body(bool needSelf, int line)
+{
+    Q_UNUSED(needSelf)
+
+    // '(' parlist ')' block end
+    FunctionContext function;
+    this->functions.append(function);
+
+    Closer closer;
+    closer.what = TK_END;
+    closer.who = TK_FUNCTION;
+    closer.line = line;
+    this->closers.append(closer);
+
+    this->checkNext('(');
+    this->parameterList();
+    this->checkNext(')');
+    this->block();
+
+    this->closers.removeLast();
+    this->checkMatch(TK_END, TK_FUNCTION, line);
+
+    this->functions.removeLast();
+}
+
+void LuaRecoveringParser::parameterList(void)
+{
+    if (')' == this->current().type)
+    {
+        return;
+    }
+
+    do
+    {
+        switch (this->current().type)
+        {
+        case TK_NAME:
+            this->next();
+            break;
+        case TK_DOTS:
+            this->next();
+            this->functions.last().vararg = true;
+            break;
+        default:
+            this->syntaxError("<name> or '...' expected");
+            return;
+        }
+    } while (false == this->functions.last().vararg && true == this->testNext(','));
+}
+
+void LuaRecoveringParser::expressionList(void)
+{
+    this->expression();
+
+    while (true == this->testNext(','))
+    {
+        this->expression();
+    }
+}
+
+void LuaRecoveringParser::expression(void)
+{
+    this->subExpression(0);
+}
+
+void LuaRecoveringParser::subExpression(int limit)
+{
+    if (++this->level > maxSyntaxLevels)
+    {
+        this->syntaxError("chunk has too many syntax levels");
+        --this->level;
+        return;
+    }
+
+    const int token = this->current().type;
+
+    if (TK_NOT == token || '-' == token || '#' == token)
+    {
+        this->next();
+        this->subExpression(unaryPriority);
+    }
+    else
+    {
+        this->simpleExpression();
+    }
+
+    int left = 0;
+    int right = 0;
+
+    while (true == binaryPriority(this->current().type, left, right) && left > limit)
+    {
+        this->next();
+        this->subExpression(right);
+    }
+
+    --this->level;
+}
+
+void LuaRecoveringParser::simpleExpression(void)
+{
+    switch (this->current().type)
+    {
+    case TK_NUMBER: case TK_STRING: case TK_NIL: case TK_TRUE: case TK_FALSE: case lexErrorToken:
+        this->next();
+        break;
+    case TK_DOTS:
+        if (false == this->functions.last().vararg)
+        {
+            this->syntaxError("cannot use '...' outside a vararg function");
+        }
+        this->next();
+        break;
+    case '{':
+        this->constructor();
+        break;
+    case TK_FUNCTION:
+    {
+        const int line = this->current().line;
+        this->next();
+        this->body(false, line);
+        break;
+    }
+    default:
+        this->primaryExpression();
+        break;
+    }
+}
+
+LuaRecoveringParser::ExpressionKind LuaRecoveringParser::primaryExpression(void)
+{
+    // prefixexp { '.' Name | '[' exp ']' | ':' Name funcargs | funcargs }
+    ExpressionKind kind = this->prefixExpression();
+
+    for (;;)
+    {
+        switch (this->current().type)
+        {
+        case '.':
+            this->next();
+            this->checkName();
+            kind = Variable;
+            break;
+        case '[':
+            this->next();
+            this->expression();
+            this->checkNext(']');
+            kind = Variable;
+            break;
+        case ':':
+            this->next();
+            this->checkName();
+            this->functionArguments();
+            kind = Call;
+            break;
+        case '(': case TK_STRING: case '{':
+            this->functionArguments();
+            kind = Call;
+            break;
+        default:
+            return kind;
+        }
+
+        if (true == this->panic)
+        {
+            return kind;
+        }
+    }
+}
+
+LuaRecoveringParser::ExpressionKind LuaRecoveringParser::prefixExpression(void)
+{
+    // Name | '(' expr ')'
+    switch (this->current().type)
+    {
+    case '(':
+    {
+        const int line = this->current().line;
+        this->next();
+        this->expression();
+        this->checkMatch(')', '(', line);
+        return Other;
+    }
+    case TK_NAME:
+        this->next();
+        return Variable;
+    default:
+        this->syntaxError("unexpected symbol");
+        return Other;
+    }
+}
+
+void LuaRecoveringParser::functionArguments(void)
+{
+    const int line = this->current().line;
+
+    switch (this->current().type)
+    {
+    case '(':
+    {
+        // A call, which starts on a new line, could as well be a new statement
+        if (this->position > 0 && line != this->tokens.at(this->position - 1).line)
+        {
+            this->syntaxError("ambiguous syntax (function call x new statement)");
+        }
+        this->next();
+        if (')' != this->current().type)
+        {
+            this->expressionList();
+        }
+        this->checkMatch(')', '(', line);
+        break;
+    }
+    case '{':
+        this->constructor();
+        break;
+    case TK_STRING:
+        this->next();
+        break;
+    default:
+        this->syntaxError("function arguments expected");
+        break;
+    }
+}
+
+void LuaRecoveringParser::constructor(void)
+{
+    // '{' [ field { fieldsep field } [ fieldsep ] ] '}'
+    const int line = this->current().line;
+    this->checkNext('{');
+
+    do
+    {
+        if ('}' == this->current().type)
+        {
+            break;
+        }
+
+        switch (this->current().type)
+        {
+        case TK_NAME:
+            if ('=' == this->lookahead().type)
+            {
+                this->next();
+                this->next();
+            }
+            this->expression();
+            break;
+        case '[':
+            this->next();
+            this->expression();
+            this->checkNext(']');
+            this->checkNext('=');
+            this->expression();
+            break;
+        default:
+            this->expression();
+            break;
+        }
+    } while (false == this->panic && (true == this->testNext(',') || true == this->testNext(';')));
+
+    this->checkMatch('}', '{', line);
+}
@@ -0,0 +1,153 @@
+#ifndef LUARECOVERINGPARSER_H
+#define LUARECOVERINGPARSER_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+
+#include "backend/luasyntaxchecker.h"
+
+// Syntax only parser for lua 5.1, which does not stop at the first error. It works on the token stream of the vendored lua lexer (llex.c),
+// so that tokens are read exactly like luac reads them, and resynchronizes at the next statement after an error.
+// The errors carry the columns of the offending token, the messages are worded like the ones of luac.
+class LuaRecoveringParser
+{
+public:
+    LuaRecoveringParser();
+
+    // Parses the utf8 code, chunkName is used as prefix of the messages, e.g. "Scene1_barrel_0.lua:12: 'end' expected near 'local'"
+    QList<LuaSyntaxChecker::Error> parse(lua_State* lua, const char* data, size_t size, const QString& chunkName);
+private:
+    struct Token
+    {
+        int type = 0;
+        int start = 0; // Byte offsets in the code
+        int end = 0;
+        int line = 0;
+    };
+
+    // What a block must be closed with, e.g. 'end' for a function opened at line 3
+    struct Closer
+    {
+        int what = 0;
+        int who = 0;
+        int line = 0;
+    };
+
+    struct FunctionContext
+    {
+        bool vararg = false;
+        int loopDepth = 0;
+    };
+
+    enum ExpressionKind
+    {
+        Other,
+        Variable,
+        Call
+    };
+private:
+    void tokenize(lua_State* lua);
+
+    int lineOf(int offset) const;
+
+    int columnOf(int offset, int line) const;
+
+    const Token& current(void) const;
+
+    const Token& lookahead(void) const;
+
+    void next(void);
+
+    bool testNext(int token);
+
+    void check(int token);
+
+    void checkNext(int token);
+
+    void checkMatch(int what, int who, int line);
+
+    void checkName(void);
+
+    void syntaxError(const QString& message);
+
+    void errorExpected(int token);
+
+    void addError(const Token& token, const QString& message);
+
+    QString tokenToString(int token) const;
+
+    QString tokenText(const Token& token) const;
+
+    bool blockFollow(int token) const;
+
+    bool isSynchronizationPoint(void) const;
+
+    void synchronize(void);
+
+    void block(void);
+
+    bool statement(void);
+
+    void ifStatement(int line);
+
+    void testThenBlock(void);
+
+    void whileStatement(int line);
+
+    void doStatement(int line);
+
+    void forStatement(int line);
+
+    void forBody(void);
+
+    void repeatStatement(int line);
+
+    void functionStatement(int line);
+
+    void localFunction(int line);
+
+    void localStatement(void);
+
+    void returnStatement(void);
+
+    void breakStatement(void);
+
+    void expressionStatement(void);
+
+    void assignment(ExpressionKind kind);
+
+    void body(bool needSelf, int line);
+
+    void parameterList(void);
+
+    void expressionList(void);
+
+    void expression(void);
+
+    void subExpression(int limit);
+
+    void simpleExpression(void);
+
+    ExpressionKind primaryExpression(void);
+
+    ExpressionKind prefixExpression(void);
+
+    void functionArguments(void);
+
+    void constructor(void);
+private:
+    const char* data;
+    size_t size;
+    QString chunkName;
+    QVector<int> lineStarts; // Byte offset of each line
+    QVector<Token> tokens;
+    int position;
+    bool panic; // Set after an error until the parser is in sync again, so that one mistake is not reported over and over
+    int level;
+    QVector<Closer> closers;
+    QVector<FunctionContext> functions;
+    QList<LuaSyntaxChecker::Error> errors;
+};
+
+#endif // LUARECOVERINGPARSER_H
@@ -0,0 +1,260 @@
+#include "backend/luaruntimeerror.h"
+
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QVariantList>
+
+namespace
+{
+    // Chunk names as lua prints them: [string "..."], [C] or a file name, which may start with a drive letter
+    const QString sourcePattern = R"((\[string ".*?"\]|\[C\]|(?:[A-Za-z]:)?[^:]*))";
+
+    QString normalizedSource(const QString& source)
+    {
+        // Chunks, which have been loaded with luaL_loadbuffer or loadstring, are named [string "name"]
+        static const QRegularExpression stringChunkRegex(R"(^\[string "(.*)"\]$)");
+
+        const QRegularExpressionMatch match = stringChunkRegex.match(source);
+        if (true == match.hasMatch())
+        {
+            return match.captured(1);
+        }
+        return source.trimmed();
+    }
+
+    bool belongsToScript(const QString& source, const QString& filePathName)
+    {
+        if (true == source.isEmpty())
+        {
+            // NOWA-Design may send just the line, then it is the script itself
+            return true;
+        }
+
+        if (0 == QString::compare(source, filePathName, Qt::CaseInsensitive))
+        {
+            return true;
+        }
+
+        // Long chunk names are shortened by lua, e.g. ".../scripts/Player.lua"
+        if (true == source.startsWith("..."))
+        {
+            return filePathName.endsWith(source.mid(3), Qt::CaseInsensitive);
+        }
+
+        return 0 == QString::compare(QFileInfo(source).fileName(), QFileInfo(filePathName).fileName(), Qt::CaseInsensitive);
+    }
+
+    bool isIdentifierChar(QChar c)
+    {
+        return true == c.isLetterOrNumber() || '_' == c;
+    }
+
+    // Position of the name as a whole word in the line, -1 if it is not there
+    qsizetype indexOfWord(const QString& line, const QString& word)
+    {
+        for (qsizetype index = line.indexOf(word); -1 != index; index = line.indexOf(word, index + 1))
+        {
+            const qsizetype after = index + word.size();
+            if ((0 == index || false == isIdentifierChar(line[index - 1])) && (line.size() == after || false == isIdentifierChar(line[after])))
+            {
+                return index;
+            }
+        }
+        return -1;
+    }
+}
+
+LuaRuntimeError LuaRuntimeError::parse(const QString& errorMessage, int line, int start, int end, qint64 timestamp)
+{
+    static const QRegularExpression locationRegex("^" + sourcePattern + R"(:(\d+):\s*(.*)$)");
+    static const QRegularExpression tracebackRegex("^" + sourcePattern + R"(:(?:(\d+):)?\s*in\s+(.*)$)");
+    static const QRegularExpression functionNameRegex(R"(^function\s+'(.*)'$)");
+
+    LuaRuntimeError runtimeError;
+    // Parsing happens after coalescing and maybe after the tab has been loaded, the time of the report is the one that counts
+    runtimeError.timestamp = 0 == timestamp ? QDateTime::currentDateTime() : QDateTime::fromMSecsSinceEpoch(timestamp);
+
+    const QStringList lines = errorMessage.split('\n');
+
+    // The first line is the message with the location, where the error occurred
+    Frame errorFrame;
+    const QString firstLine = lines.value(0).trimmed();
+    const QRegularExpressionMatch locationMatch = locationRegex.match(firstLine);
+
+    if (true == locationMatch.hasMatch())
+    {
+        errorFrame.source = normalizedSource(locationMatch.captured(1));
+        errorFrame.line = locationMatch.captured(2).toInt();
+        runtimeError.message = locationMatch.captured(3);
+    }
+    else
+    {
+        runtimeError.message = firstLine;
+    }
+
+    if (-1 != line)
+    {
+        errorFrame.line = line;
+        runtimeError.addressedToDocument = true;
+    }
+
+    errorFrame.start = start;
+    errorFrame.end = end;
+
+    runtimeError.frames.append(errorFrame);
+
+    bool inTraceback = false;
+    bool luaFrameSeen = false;
+
+    for (int i = 1; i < lines.size(); ++i)
+    {
+        const QString currentLine = lines[i].trimmed();
+
+        if (false == inTraceback)
+        {
+            inTraceback = currentLine.startsWith("stack traceback:");
+            if (false == inTraceback && false == currentLine.isEmpty())
+            {
+                // Messages may span several lines
+                runtimeError.message += "\n" + currentLine;
+            }
+            continue;
+        }
+
+        // Lines like "(tail call): ?" or "..." for skipped levels carry no location
+        const QRegularExpressionMatch tracebackMatch = tracebackRegex.match(currentLine);
+        if (false == tracebackMatch.hasMatch())
+        {
+            continue;
+        }
+
+        Frame frame;
+        frame.source = normalizedSource(tracebackMatch.captured(1));
+        frame.line = true == tracebackMatch.captured(2).isEmpty() ? -1 : tracebackMatch.captured(2).toInt();
+
+        const QString where = tracebackMatch.captured(3).trimmed();
+        const QRegularExpressionMatch functionNameMatch = functionNameRegex.match(where);
+
+        if (true == functionNameMatch.hasMatch())
+        {
+            frame.functionName = functionNameMatch.captured(1);
+        }
+        else if ("main chunk" != where && "?" != where)
+        {
+            // Anonymous functions are named by their definition, e.g. "function <Player.lua:28>"
+            frame.functionName = where;
+        }
+
+        if (false == luaFrameSeen)
+        {
+            // C functions above the innermost lua frame are the ones, which raised the error, e.g. error or assert
+            if (-1 == frame.line)
+            {
+                continue;
+            }
+
+            luaFrameSeen = true;
+
+            // The innermost lua frame is the location of the message again, it just adds the name of the function
+            Frame& firstFrame = runtimeError.frames.first();
+            if (frame.line == firstFrame.line && (true == firstFrame.source.isEmpty() || frame.source == firstFrame.source))
+            {
+                firstFrame.source = frame.source;
+                firstFrame.functionName = frame.functionName;
+                continue;
+            }
+        }
+
+        runtimeError.frames.append(frame);
+    }
+
+    return runtimeError;
+}
+
+void LuaRuntimeError::mapToDocument(const QString& filePathName, const QString& content)
+{
+    static const QRegularExpression memberSeparatorRegex("[.:]");
+
+    const QStringList lines = content.split('\n');
+
+    for (int i = 0; i < this->frames.size(); ++i)
+    {
+        Frame& frame = this->frames[i];
+
+        // The parsed source only decides for the frames of the traceback, if NOWA-Design has told the line of the first one
+        const bool addressed = 0 == i && true == this->addressedToDocument;
+        frame.inDocument = frame.line >= 1 && frame.line <= lines.size() && (true == addressed || true == belongsToScript(frame.source, filePathName));
+
+        if (false == frame.inDocument)
+        {
+            frame.start = 0;
+            frame.end = 0;
+            continue;
+        }
+
+        if (0 == i)
+        {
+            // Lua only knows the line, where the error occurred, the columns are the ones NOWA-Design sent, if any
+            continue;
+        }
+
+        frame.start = 0;
+        frame.end = 0;
+
+        // The line of an outer frame is where it called the frame before, so the call is marked
+        QString calledName = this->frames[i - 1].functionName;
+        calledName = calledName.mid(calledName.lastIndexOf(memberSeparatorRegex) + 1);
+
+        if (true == calledName.isEmpty() || true == calledName.startsWith("function"))
+        {
+            continue;
+        }
+
+        const qsizetype callIndex = indexOfWord(lines[frame.line - 1], calledName);
+
+        if (-1 != callIndex)
+        {
+            frame.start = static_cast<int>(callIndex);
+            frame.end = static_cast<int>(callIndex + calledName.size());
+        }
+    }
+}
+
+QList<LuaRuntimeError::Frame> LuaRuntimeError::getDocumentFrames(void) const
+{
+    QList<Frame> documentFrames;
+
+    for (const Frame& frame : this->frames)
+    {
+        if (true == frame.inDocument)
+        {
+            documentFrames.append(frame);
+        }
+    }
+
+    return documentFrames;
+}
+
+QVariantMap LuaRuntimeError::toVariantMap(void) const
+{
+    QVariantList frameList;
+
+    for (const Frame& frame : this->frames)
+    {
+        QVariantMap frameMap;
+        frameMap["source"] = frame.source;
+        frameMap["line"] = frame.line;
+        frameMap["functionName"] = frame.functionName;
+        frameMap["inDocument"] = frame.inDocument;
+        frameMap["start"] = frame.start;
+        frameMap["end"] = frame.end;
+        frameList.append(frameMap);
+    }
+
+    QVariantMap runtimeErrorMap;
+    runtimeErrorMap["message"] = this->message;
+    runtimeErrorMap["timestamp"] = this->timestamp.toString("HH:mm:ss.zzz");
+    runtimeErrorMap["frames"] = frameList;
+
+    return runtimeErrorMap;
+}
@@ -0,0 +1,50 @@
+#ifndef LUARUNTIMEERROR_H
+#define LUARUNTIMEERROR_H
+
+#include <QString>
+#include <QList>
+#include <QDateTime>
+#include <QVariantMap>
+
+// A runtime error, which NOWA-Design sends, parsed into its message and the frames of the lua stack traceback, e.g.:
+// Player.lua:12: attempt to index a nil value
+// stack traceback:
+//     [C]: in function 'error'
+//     Player.lua:12: in function 'update'
+//     Player.lua:30: in function <Player.lua:28>
+// The first frame is the location of the message itself. Frames of the script, the error is shown for, are mapped to a position in its text.
+class LuaRuntimeError
+{
+public:
+    struct Frame
+    {
+        QString source; // Chunk of the frame, e.g. "Player.lua", "[C]" for c functions
+        int line = -1; // -1 for c functions
+        QString functionName; // Empty for the main chunk or if unknown
+        bool inDocument = false; // Whether the frame belongs to the script and the position is valid
+        int start = 0; // Columns in the line, 0 and 0 if only the line is known
+        int end = 0;
+    };
+public:
+    // Parses the message, line overwrites the line of the first frame, if it is not -1. Start and end are its columns, if NOWA-Design knows them.
+    // timestamp is when the error occurred, ms since epoch, 0 for now.
+    static LuaRuntimeError parse(const QString& errorMessage, int line = -1, int start = 0, int end = 0, qint64 timestamp = 0);
+
+    // Maps the frames, which belong to the script with the given path, to positions in its content
+    void mapToDocument(const QString& filePathName, const QString& content);
+
+    // The frames, which belong to the script, the first one is where the error occurred
+    QList<Frame> getDocumentFrames(void) const;
+
+    // For qml: message, timestamp and frames as a list of maps
+    QVariantMap toVariantMap(void) const;
+public:
+    QString message; // First line of the error without location
+    QList<Frame> frames;
+    QDateTime timestamp;
+    // NOWA-Design sent the error for the script together with its line. The first frame is in the script then, even if the chunk name of
+    // the message is another one, e.g. a shared module or [string "Player"].
+    bool addressedToDocument = false;
+};
+
+#endif // LUARUNTIMEERROR_H
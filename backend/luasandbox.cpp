@@ -0,0 +1,253 @@
+#include "backend/luasandbox.h"
+
+#include <QDebug>
+
+#include <cstdlib>
+
+namespace
+{
+    // Only libraries without file system or process access
+    const luaL_Reg safeLibraries[] =
+    {
+        { "", luaopen_base },
+        { LUA_TABLIBNAME, luaopen_table },
+        { LUA_STRLIBNAME, luaopen_string },
+        { LUA_MATHLIBNAME, luaopen_math },
+        { Q_NULLPTR, Q_NULLPTR }
+    };
+
+    const char* binaryChunkMessage = "binary chunks are not allowed in the lua sandbox";
+
+    bool isBinaryChunk(const char* code, size_t length)
+    {
+        return length > 0 && LUA_SIGNATURE[0] == code[0];
+    }
+
+    // Like luaL_loadbuffer, but results like load: the function or nil and the message
+    int loadSourceResult(lua_State* lua, const char* code, size_t length, const char* chunkName)
+    {
+        if (true == isBinaryChunk(code, length))
+        {
+            lua_pushnil(lua);
+            lua_pushstring(lua, binaryChunkMessage);
+            return 2;
+        }
+
+        if (0 != luaL_loadbuffer(lua, code, length, chunkName))
+        {
+            lua_pushnil(lua);
+            lua_insert(lua, -2);
+            return 2;
+        }
+        return 1;
+    }
+}
+
+LuaSandbox::LuaSandbox(int instructionLimit, size_t memoryLimit)
+    : lua(Q_NULLPTR),
+    instructionLimit(instructionLimit),
+    memoryLimit(memoryLimit),
+    usedMemory(0),
+    exhausted(false)
+{
+    this->lua = lua_newstate(&LuaSandbox::allocate, this);
+
+    if (Q_NULLPTR == this->lua)
+    {
+        qWarning() << "Could not create lua sandbox state, memory limit:" << this->memoryLimit;
+        return;
+    }
+
+    this->openSafeLibraries();
+
+    // The hook is called once after the given count of instructions has been executed, which is the budget of the whole execution
+    lua_sethook(this->lua, &LuaSandbox::instructionHook, LUA_MASKCOUNT, this->instructionLimit);
+}
+
+LuaSandbox::~LuaSandbox()
+{
+    if (Q_NULLPTR != this->lua)
+    {
+        lua_close(this->lua);
+    }
+}
+
+bool LuaSandbox::execute(const QByteArray& luaCode, QString& errorMessage)
+{
+    if (Q_NULLPTR == this->lua)
+    {
+        errorMessage = "Lua sandbox is not available.";
+        return false;
+    }
+
+    if (true == isBinaryChunk(luaCode.constData(), static_cast<size_t>(luaCode.size())))
+    {
+        errorMessage = binaryChunkMessage;
+        return false;
+    }
+
+    int result = luaL_loadbuffer(this->lua, luaCode.constData(), luaCode.size(), "sandbox");
+
+    if (0 == result)
+    {
+        result = lua_pcall(this->lua, 0, 0, 0);
+    }
+
+    // The budget is over for good, the state is thrown away anyway
+    lua_sethook(this->lua, Q_NULLPTR, 0, 0);
+
+    if (0 != result)
+    {
+        const char* errorMsg = lua_tostring(this->lua, -1);
+        errorMessage = QString::fromUtf8(Q_NULLPTR != errorMsg ? errorMsg : "Unknown lua sandbox error");
+
+        if (LUA_ERRMEM == result)
+        {
+            errorMessage += " (sandbox memory limit: " + QString::number(this->memoryLimit) + " bytes)";
+        }
+
+        lua_pop(this->lua, 1); // Pop the error message from the stack
+        return false;
+    }
+
+    return true;
+}
+
+size_t LuaSandbox::getUsedMemory(void) const
+{
+    return this->usedMemory;
+}
+
+int LuaSandbox::getInstructionLimit(void) const
+{
+    return this->instructionLimit;
+}
+
+size_t LuaSandbox::getMemoryLimit(void) const
+{
+    return this->memoryLimit;
+}
+
+void LuaSandbox::openSafeLibraries(void)
+{
+    for (const luaL_Reg* library = safeLibraries; Q_NULLPTR != library->func; ++library)
+    {
+        lua_pushcfunction(this->lua, library->func);
+        lua_pushstring(this->lua, library->name);
+        lua_call(this->lua, 1, 0);
+    }
+
+    // Base library functions, which would reach the file system
+    lua_pushnil(this->lua);
+    lua_setglobal(this->lua, "dofile");
+    lua_pushnil(this->lua);
+    lua_setglobal(this->lua, "loadfile");
+
+    // Hand crafted bytecode could break out of the state
+    lua_pushcfunction(this->lua, &LuaSandbox::loadSource);
+    lua_setglobal(this->lua, "load");
+    lua_pushcfunction(this->lua, &LuaSandbox::loadSourceString);
+    lua_setglobal(this->lua, "loadstring");
+
+    // Scripts may print, but the sandbox has no console
+    lua_pushcfunction(this->lua, &LuaSandbox::doNothing);
+    lua_setglobal(this->lua, "print");
+}
+
+void* LuaSandbox::allocate(void* userData, void* pointer, size_t oldSize, size_t newSize)
+{
+    LuaSandbox* luaSandbox = static_cast<LuaSandbox*>(userData);
+
+    if (0 == newSize)
+    {
+        luaSandbox->usedMemory -= oldSize;
+        std::free(pointer);
+        return Q_NULLPTR;
+    }
+
+    // Refuses to grow beyond the memory cap, lua raises a memory error in this case
+    if (newSize > oldSize && luaSandbox->usedMemory + (newSize - oldSize) > luaSandbox->memoryLimit)
+    {
+        return Q_NULLPTR;
+    }
+
+    void* newPointer = std::realloc(pointer, newSize);
+    if (Q_NULLPTR != newPointer)
+    {
+        luaSandbox->usedMemory = luaSandbox->usedMemory - oldSize + newSize;
+    }
+
+    return newPointer;
+}
+
+void LuaSandbox::instructionHook(lua_State* lua, lua_Debug* debug)
+{
+    Q_UNUSED(debug)
+
+    void* userData = Q_NULLPTR;
+    lua_getallocf(lua, &userData);
+    LuaSandbox* luaSandbox = static_cast<LuaSandbox*>(userData);
+
+    // The error is an ordinary one, which pcall within the script could catch and go on.
+    // So from now on the hook fires after each instruction, until the error reaches execute.
+    if (false == luaSandbox->exhausted)
+    {
+        luaSandbox->exhausted = true;
+        lua_sethook(lua, &LuaSandbox::instructionHook, LUA_MASKCOUNT, 1);
+    }
+
+    // Level 0 is the function being executed, so that the error carries the line, at which the budget ran out
+    luaL_where(lua, 0);
+    lua_pushfstring(lua, "instruction limit of %d exceeded", luaSandbox->instructionLimit);
+    lua_concat(lua, 2);
+    lua_error(lua);
+}
+
+int LuaSandbox::doNothing(lua_State* lua)
+{
+    Q_UNUSED(lua)
+    return 0;
+}
+
+int LuaSandbox::loadSource(lua_State* lua)
+{
+    luaL_checktype(lua, 1, LUA_TFUNCTION);
+    const char* chunkName = luaL_optstring(lua, 2, "=(load)");
+
+    // The pieces of the reader are joined first, so that the start of the chunk can be checked, before lua reads it
+    luaL_Buffer buffer;
+    luaL_buffinit(lua, &buffer);
+
+    for (;;)
+    {
+        lua_pushvalue(lua, 1);
+        lua_call(lua, 0, 1);
+
+        if (true == lua_isnil(lua, -1) || (true == lua_isstring(lua, -1) && 0 == lua_objlen(lua, -1)))
+        {
+            lua_pop(lua, 1);
+            break;
+        }
+
+        if (0 == lua_isstring(lua, -1))
+        {
+            return luaL_error(lua, "reader function must return a string");
+        }
+
+        luaL_addvalue(&buffer);
+    }
+
+    luaL_pushresult(&buffer);
+
+    size_t length = 0;
+    const char* code = lua_tolstring(lua, -1, &length);
+    return loadSourceResult(lua, code, length, chunkName);
+}
+
+int LuaSandbox::loadSourceString(lua_State* lua)
+{
+    size_t length = 0;
+    const char* code = luaL_checklstring(lua, 1, &length);
+    const char* chunkName = luaL_optstring(lua, 2, code);
+    return loadSourceResult(lua, code, length, chunkName);
+}
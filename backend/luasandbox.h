@@ -0,0 +1,56 @@
+#ifndef LUASANDBOX_H
+#define LUASANDBOX_H
+
+#include <QByteArray>
+#include <QString>
+
+extern "C"
+{
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+}
+
+// Separate, throw away lua state for optionally executing a script during a check.
+// The state only has the safe standard libraries, an instruction budget enforced by a count hook and a memory cap enforced by its allocator,
+// so that executing a script has a bounded cost and does never touch the state used for syntax checking.
+// Once the budget is exhausted, every further instruction raises the error again, so that pcall within the script can not catch it for good.
+// Binary chunks are refused, lua 5.1 does not verify bytecode.
+class LuaSandbox
+{
+public:
+    explicit LuaSandbox(int instructionLimit = 1000000, size_t memoryLimit = 32 * 1024 * 1024);
+
+    ~LuaSandbox();
+
+    bool execute(const QByteArray& luaCode, QString& errorMessage);
+
+    size_t getUsedMemory(void) const;
+
+    int getInstructionLimit(void) const;
+
+    size_t getMemoryLimit(void) const;
+private:
+    Q_DISABLE_COPY(LuaSandbox)
+
+    void openSafeLibraries(void);
+
+    static void* allocate(void* userData, void* pointer, size_t oldSize, size_t newSize);
+
+    static void instructionHook(lua_State* lua, lua_Debug* debug);
+
+    static int doNothing(lua_State* lua);
+
+    // load and loadstring of the base library, which only accept source code
+    static int loadSource(lua_State* lua);
+
+    static int loadSourceString(lua_State* lua);
+private:
+    lua_State* lua;
+    int instructionLimit;
+    size_t memoryLimit;
+    size_t usedMemory;
+    bool exhausted; // The instruction budget ran out, sticky until the execution ends
+};
+
+#endif // LUASANDBOX_H
@@ -7,6 +7,8 @@
 #include <QSharedPointer>
 #include <QMap>
 
+#include "backend/luaruntimeerror.h"
+
 extern "C"
 {
 #include <lua.h>
@@ -28,22 +30,20 @@ public:
 
     void generateIntellisense(const QString& currentText);  // Generate intellisense based on current text
 
-    bool loadScriptFromFile(const QString& filePathName);  // Load and parse a Lua script
-
-    void checkSyntax(const QString& luaCode);
+    void setLoadedContent(const QString& content); // Content, which the LuaScriptLoader has read on a worker thread, when the tab is opened, signal_luaScriptLoaded tells it
 
-    void checkRuntimeError(const QString& errorMessage, int line, int start, int end);
+    void setContent(const QString& content); // The latest text of the editor
 
-    bool saveLuaScript(const QString& content);
+    // timestamp is when the error has been reported, ms since epoch
+    void checkRuntimeError(const QString& errorMessage, int line, int start, int end, qint64 timestamp = 0);
 Q_SIGNALS:
     void signal_luaScriptLoaded(const QString& content);
-    void signal_syntaxCheckResult(bool valid, int line, int start, int end, const QString& message);
     void signal_runtimeError(bool valid, int line, int start, int end, const QString& message);
+    void signal_runtimeErrorRecord(const LuaRuntimeError& runtimeError);
 private:
     // Internal helper methods and members for parsing
     QStringList searchSuggestions(const QString& text);
 private:
-    lua_State* lua;  // Lua state
     QString filePathName;
     QString content;
 };
@@ -0,0 +1,170 @@
+#include "backend/luascriptloader.h"
+
+#include <QFile>
+#include <QElapsedTimer>
+#include <QDebug>
+
+namespace
+{
+    // Must be replaced, else addTab, indent does not work correctly, as it messes up with \t
+    const int tabWidth = 4;
+
+    // Most that one input byte can produce: an expanded tab. A surrogate pair takes 2 units for 4 bytes.
+    const qsizetype maxUnitsPerStep = tabWidth;
+
+    const char16_t replacementCharacter = 0xFFFD;
+
+    bool isContinuation(uchar c)
+    {
+        return 0x80 == (c & 0xC0);
+    }
+}
+
+LuaScriptLoader::Result LuaScriptLoader::load(const QString& filePathName)
+{
+    Result result;
+    result.filePathName = filePathName;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(filePathName);
+    if (false == file.open(QIODevice::ReadOnly))
+    {
+        result.message = "Failed to open file: " + filePathName + " Error: " + file.errorString();
+        return result;
+    }
+
+    result.fileSize = file.size();
+
+    if (result.fileSize > 0)
+    {
+        uchar* data = file.map(0, result.fileSize);
+
+        if (Q_NULLPTR != data)
+        {
+            decode(data, result.fileSize, result.content);
+            file.unmap(data);
+        }
+        else
+        {
+            // Not every file system can map, e.g. some network drives
+            const QByteArray bytes = file.readAll();
+            decode(reinterpret_cast<const uchar*>(bytes.constData()), bytes.size(), result.content);
+        }
+    }
+
+    file.close();
+
+    result.success = true;
+    result.loadTimeMs = timer.nsecsElapsed() / 1000000.0;
+
+    qDebug() << "Lua script loaded from file:" << filePathName << "bytes:" << result.fileSize << "ms:" << result.loadTimeMs;
+
+    return result;
+}
+
+void LuaScriptLoader::decode(const uchar* data, qint64 size, QString& target)
+{
+    qint64 position = 0;
+
+    if (size >= 3 && 0xEF == data[0] && 0xBB == data[1] && 0xBF == data[2])
+    {
+        position = 3;
+    }
+
+    // Every byte gives at most one utf16 unit, except tabs. Some room for them, the rest grows on demand.
+    qsizetype capacity = static_cast<qsizetype>(size + size / 16 + maxUnitsPerStep);
+    target.resize(capacity);
+    char16_t* out = reinterpret_cast<char16_t*>(target.data());
+    qsizetype written = 0;
+
+    while (position < size)
+    {
+        if (written + maxUnitsPerStep > capacity)
+        {
+            capacity *= 2;
+            target.resize(capacity);
+            out = reinterpret_cast<char16_t*>(target.data());
+        }
+
+        const uchar c = data[position];
+
+        if (c < 0x80)
+        {
+            if ('\t' == c)
+            {
+                for (int i = 0; i < tabWidth; ++i)
+                {
+                    out[written++] = ' ';
+                }
+            }
+            else if ('\r' != c || position + 1 >= size || '\n' != data[position + 1])
+            {
+                out[written++] = c;
+            }
+            ++position;
+            continue;
+        }
+
+        // Length of the sequence and the range of its second byte, which excludes overlong encodings, surrogates and code points above U+10FFFF
+        int length = 0;
+        char32_t codePoint = 0;
+        uchar lower = 0x80;
+        uchar upper = 0xBF;
+
+        if (c >= 0xC2 && c <= 0xDF)
+        {
+            length = 2;
+            codePoint = c & 0x1F;
+        }
+        else if (c >= 0xE0 && c <= 0xEF)
+        {
+            length = 3;
+            codePoint = c & 0x0F;
+            lower = 0xE0 == c ? 0xA0 : 0x80;
+            upper = 0xED == c ? 0x9F : 0xBF;
+        }
+        else if (c >= 0xF0 && c <= 0xF4)
+        {
+            length = 4;
+            codePoint = c & 0x07;
+            lower = 0xF0 == c ? 0x90 : 0x80;
+            upper = 0xF4 == c ? 0x8F : 0xBF;
+        }
+
+        int i = 1;
+        for (; i < length && position + i < size; ++i)
+        {
+            const uchar next = data[position + i];
+            if ((1 == i && (next < lower || next > upper)) || (i > 1 && false == isContinuation(next)))
+            {
+                break;
+            }
+            codePoint = (codePoint << 6) | (next & 0x3F);
+        }
+
+        if (i < length || 0 == length)
+        {
+            // One replacement for the broken part, the next byte may start a new sequence
+            out[written++] = replacementCharacter;
+            position += i;
+            continue;
+        }
+
+        if (codePoint >= 0x10000)
+        {
+            codePoint -= 0x10000;
+            out[written++] = static_cast<char16_t>(0xD800 + (codePoint >> 10));
+            out[written++] = static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF));
+        }
+        else
+        {
+            out[written++] = static_cast<char16_t>(codePoint);
+        }
+
+        position += length;
+    }
+
+    target.resize(written);
+}
@@ -0,0 +1,28 @@
+#ifndef LUASCRIPTLOADER_H
+#define LUASCRIPTLOADER_H
+
+#include <QString>
+
+// Loads a lua script for the editor. The file is memory mapped and decoded from utf8 in one pass, in which tabs are expanded
+// to spaces and \r\n becomes \n, so that there is no copy of the raw bytes and no second pass over the text.
+// load has no side effects, it is meant to run on a worker thread, e.g. with QtConcurrent::run.
+class LuaScriptLoader
+{
+public:
+    struct Result
+    {
+        QString filePathName;
+        QString content;
+        bool success = false;
+        qint64 fileSize = 0;
+        double loadTimeMs = 0.0;
+        QString message;
+    };
+public:
+    static Result load(const QString& filePathName);
+
+    // Decodes the utf8 bytes into target and expands tabs. Invalid sequences become U+FFFD, a leading bom is skipped.
+    static void decode(const uchar* data, qint64 size, QString& target);
+};
+
+#endif // LUASCRIPTLOADER_H
@@ -0,0 +1,122 @@
+#include "backend/luastatepool.h"
+#include "backend/luaarena.h"
+
+#include <QThread>
+#include <QMutexLocker>
+#include <QDebug>
+
+LuaStatePool* LuaStatePool::ms_pInstance = Q_NULLPTR;
+QMutex LuaStatePool::ms_mutex;
+
+namespace
+{
+    // Memory an arena keeps after a check, more is only needed for unusually large scripts
+    const size_t retainedArenaMemory = 4 * 1024 * 1024;
+}
+
+LuaStatePool::LuaStatePool()
+    : maxStates(qMax(2, QThread::idealThreadCount()))
+{
+    // The entries are never moved, the arenas are handed to lua as user data
+    this->entries.resize(this->maxStates);
+}
+
+LuaStatePool::~LuaStatePool()
+{
+    // Nothing to close, the states live in their arenas
+    for (const Entry& entry : std::as_const(this->entries))
+    {
+        delete entry.arena;
+    }
+}
+
+LuaStatePool* LuaStatePool::instance()
+{
+    QMutexLocker lock(&ms_mutex);
+
+    if (ms_pInstance == Q_NULLPTR)
+    {
+        ms_pInstance = new LuaStatePool();
+    }
+    return ms_pInstance;
+}
+
+lua_State* LuaStatePool::acquire(void)
+{
+    QMutexLocker lock(&this->mutex);
+
+    while (true)
+    {
+        for (Entry& entry : this->entries)
+        {
+            if (true == entry.inUse)
+            {
+                continue;
+            }
+
+            if (Q_NULLPTR == entry.arena)
+            {
+                entry.arena = new LuaArena();
+            }
+
+            entry.lua = lua_newstate(&LuaArena::allocate, entry.arena);
+
+            if (Q_NULLPTR == entry.lua)
+            {
+                qWarning() << "Could not create lua state for the syntax check";
+                entry.arena->reset(retainedArenaMemory);
+                return Q_NULLPTR;
+            }
+
+            // Collecting would only walk the objects, the arena frees nothing before the reset anyway
+            lua_gc(entry.lua, LUA_GCSTOP, 0);
+
+            entry.inUse = true;
+            return entry.lua;
+        }
+
+        this->condition.wait(&this->mutex);
+    }
+}
+
+void LuaStatePool::release(lua_State* lua)
+{
+    if (Q_NULLPTR == lua)
+    {
+        return;
+    }
+
+    QMutexLocker lock(&this->mutex);
+
+    for (int i = 0; i < this->entries.size(); ++i)
+    {
+        Entry& entry = this->entries[i];
+
+        if (lua != entry.lua)
+        {
+            continue;
+        }
+
+        // Only a check, which took more than the arena keeps, is worth telling, what it took in total, since frees are ignored
+        if (entry.arena->getReservedMemory() > retainedArenaMemory)
+        {
+            qDebug() << "Lua state" << i << "of the pool: lua counts" << lua_gc(lua, LUA_GCCOUNT, 0) << "KB, arena used"
+                     << entry.arena->getUsedMemory() / 1024 << "KB of" << entry.arena->getReservedMemory() / 1024 << "KB";
+        }
+
+        // Throws the whole state away at once
+        entry.arena->reset(retainedArenaMemory);
+        entry.lua = Q_NULLPTR;
+        entry.inUse = false;
+
+        this->condition.wakeOne();
+        return;
+    }
+
+    qWarning() << "Lua state released, which does not belong to the pool";
+}
+
+int LuaStatePool::getMaxStates(void) const
+{
+    return this->maxStates;
+}
@@ -0,0 +1,66 @@
+#ifndef LUASTATEPOOL_H
+#define LUASTATEPOOL_H
+
+#include <QVector>
+#include <QMutex>
+#include <QWaitCondition>
+
+extern "C"
+{
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+}
+
+class LuaArena;
+
+// Small set of bare lua states for syntax checks, shared by all open scripts, so that memory does not grow with the count of tabs.
+// Each state lives in its own LuaArena. A state is only borrowed for one check, on release the arena is reset
+// and the next borrower gets a fresh state, so that nothing of a check survives into the next one.
+// The states have no libraries, they are only used to compile.
+class LuaStatePool
+{
+public:
+    /**
+     * @brief instance is the getter used to receive the object of this singleton implementation.
+     * @returns singleton instance of this
+     */
+    static LuaStatePool* instance();
+
+    /**
+     * @brief acquire borrows a state for one check, it waits, if all states are borrowed.
+     * @returns fresh lua state or Q_NULLPTR, if the state could not be created
+     */
+    lua_State* acquire(void);
+
+    /**
+     * @brief release gives the state back, it must not be used anymore afterwards. The memory usage of an unusually large check is reported.
+     * @param lua state got from acquire
+     */
+    void release(lua_State* lua);
+
+    int getMaxStates(void) const;
+private:
+    LuaStatePool();
+
+    ~LuaStatePool();
+
+    Q_DISABLE_COPY(LuaStatePool)
+
+    struct Entry
+    {
+        LuaArena* arena = Q_NULLPTR;
+        lua_State* lua = Q_NULLPTR;
+        bool inUse = false;
+    };
+private:
+    static LuaStatePool* ms_pInstance;
+    static QMutex ms_mutex;
+
+    QMutex mutex;
+    QWaitCondition condition;
+    QVector<Entry> entries;
+    int maxStates;
+};
+
+#endif // LUASTATEPOOL_H
@@ -0,0 +1,466 @@
+#include "backend/luasyntaxchecker.h"
+#include "backend/luasandbox.h"
+#include "backend/luarecoveringparser.h"
+
+#include <QByteArray>
+#include <QStringView>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QDebug>
+
+namespace
+{
+    // Name, chunks are compiled with, so that cached results do not depend on the file
+    const char* cachedChunkName = "=chunk";
+
+    // Bound of the result cache, it is just cleared, when exceeded
+    const int maxCachedChunks = 4096;
+
+    // Appended to a valid chunk, compiles, unless the chunk ends with a top-level return
+    const QString endsBlockProbe = QStringLiteral("\nlocal _");
+
+    bool isIdentifierChar(QChar c)
+    {
+        const char16_t unicode = c.unicode();
+        return (unicode >= 'a' && unicode <= 'z') || (unicode >= 'A' && unicode <= 'Z') || (unicode >= '0' && unicode <= '9') || '_' == unicode;
+    }
+
+    const QChar* skipSpaces(const QChar* position, const QChar* end)
+    {
+        while (position < end && (' ' == position->unicode() || '\t' == position->unicode()))
+        {
+            ++position;
+        }
+        return position;
+    }
+
+    // Matches the keyword as a whole word at the position
+    const QChar* matchKeyword(const QChar* position, const QChar* end, const char* keyword)
+    {
+        const qsizetype length = static_cast<qsizetype>(qstrlen(keyword));
+        if (end - position < length)
+        {
+            return Q_NULLPTR;
+        }
+        for (qsizetype i = 0; i < length; ++i)
+        {
+            if (position[i].unicode() != static_cast<char16_t>(keyword[i]))
+            {
+                return Q_NULLPTR;
+            }
+        }
+        if (position + length < end && true == isIdentifierChar(position[length]))
+        {
+            return Q_NULLPTR;
+        }
+        return position + length;
+    }
+
+    // Whether a line starts a top-level function at column 0:
+    // "function Name...", "local function Name" or "Name.field = function"
+    bool startsTopLevelFunction(const QChar* line, const QChar* end)
+    {
+        const QChar* position = matchKeyword(line, end, "function");
+        if (Q_NULLPTR != position)
+        {
+            // Anonymous functions are no statements, e.g. a function within a table constructor
+            position = skipSpaces(position, end);
+            return position < end && true == isIdentifierChar(*position);
+        }
+
+        position = matchKeyword(line, end, "local");
+        if (Q_NULLPTR != position)
+        {
+            return Q_NULLPTR != matchKeyword(skipSpaces(position, end), end, "function");
+        }
+
+        position = line;
+        if (position >= end || false == isIdentifierChar(*position) || true == position->isDigit())
+        {
+            return false;
+        }
+        while (position < end && (true == isIdentifierChar(*position) || '.' == position->unicode()))
+        {
+            ++position;
+        }
+        position = skipSpaces(position, end);
+        if (position + 1 >= end || '=' != position[0].unicode() || '=' == position[1].unicode())
+        {
+            return false;
+        }
+        return Q_NULLPTR != matchKeyword(skipSpaces(position + 1, end), end, "function");
+    }
+
+    quint64 chunkKey(const QChar* data, qsizetype length)
+    {
+        return static_cast<quint64>(qHash(QStringView(data, length))) ^ (static_cast<quint64>(length) * 0x9E3779B97F4A7C15ULL);
+    }
+}
+
+LuaSyntaxChecker::LuaSyntaxChecker()
+    : sandboxExecution(false),
+    sandboxInstructionLimit(1000000),
+    sandboxMemoryLimit(32 * 1024 * 1024)
+{
+    // Executing a script during the check is optional, because game scripts usually depend on the engine api, which is not available here
+    QSettings settings("NOWA", "NOWALuaScript");
+    this->sandboxExecution = settings.value("SandboxExecution", false).toBool();
+    this->sandboxInstructionLimit = settings.value("SandboxInstructionLimit", this->sandboxInstructionLimit).toInt();
+    this->sandboxMemoryLimit = settings.value("SandboxMemoryLimit", this->sandboxMemoryLimit).toLongLong();
+}
+
+LuaSyntaxChecker::Result LuaSyntaxChecker::check(lua_State* lua, const QString& luaCode, const QString& chunkName, const std::atomic_bool* cancelled)
+{
+    Result result;
+
+    // The code is handed to lua in its utf16 form, the LuaUtf8Reader converts it block by block, while lua reads it.
+    // Only compiles the chunks. They are never executed in this state, so that a check has no side effects and globals do not pile up from check to check
+    this->splitChunks(luaCode);
+
+    for (qsizetype chunkIndex = 0; chunkIndex < this->chunks.size(); ++chunkIndex)
+    {
+        const Chunk& chunk = this->chunks.at(chunkIndex);
+        const bool lastChunk = chunkIndex + 1 == this->chunks.size();
+
+        const quint64 key = chunkKey(chunk.data, chunk.length);
+
+        auto it = this->chunkResults.constFind(key);
+        // Comparing the text costs far less than compiling it and the hash alone may collide
+        if (this->chunkResults.constEnd() == it || QStringView(it->text) != QStringView(chunk.data, chunk.length))
+        {
+            ChunkResult chunkResult;
+            chunkResult.text = QString(chunk.data, chunk.length);
+
+            const int loadResult = this->compile(lua, chunk.data, chunk.length, cachedChunkName, cancelled, chunkResult.message);
+
+            if (Q_NULLPTR != cancelled && true == cancelled->load(std::memory_order_relaxed))
+            {
+                result.cancelled = true;
+                return result;
+            }
+
+            if (LUA_ERRMEM == loadResult)
+            {
+                // The parser would find nothing wrong in code, which lua could not compile for lack of memory
+                return abortedResult("Syntax check aborted, the script is too large to be checked: " + chunkResult.message);
+            }
+
+            chunkResult.valid = 0 == loadResult;
+
+            if (false == chunkResult.valid)
+            {
+                chunkResult.errors = this->collectErrors(lua, chunk.data, chunk.length, "chunk", chunkResult.message);
+            }
+            else
+            {
+                // "return M" must be the last statement. Whether a chunk ends with it, only lua knows for sure, e.g. not within a comment or string.
+                this->probeBuffer.resize(0);
+                this->probeBuffer.append(chunk.data, chunk.length);
+                this->probeBuffer.append(endsBlockProbe);
+
+                QString probeMessage;
+                const int probeResult = this->compile(lua, this->probeBuffer.constData(), this->probeBuffer.size(), cachedChunkName, cancelled, probeMessage);
+
+                if (Q_NULLPTR != cancelled && true == cancelled->load(std::memory_order_relaxed))
+                {
+                    result.cancelled = true;
+                    return result;
+                }
+
+                if (LUA_ERRMEM == probeResult)
+                {
+                    return abortedResult("Syntax check aborted, the script is too large to be checked: " + probeMessage);
+                }
+
+                chunkResult.endsBlock = 0 != probeResult;
+            }
+
+            if (this->chunkResults.size() >= maxCachedChunks)
+            {
+                this->chunkResults.clear();
+            }
+            it = this->chunkResults.insert(key, chunkResult);
+        }
+
+        if (true == it->valid && (false == it->endsBlock || true == lastChunk))
+        {
+            continue;
+        }
+
+        // A chunk, which ends within an unclosed construct, may just have been split at the wrong place,
+        // e.g. a function field at column 0 within a table constructor. The whole document decides in this case.
+        // So it does for a chunk, which ends with a top-level return and is followed by another one, only luac's error for the whole document is right then.
+        if (true == it->valid || true == it->message.contains("<eof>") || true == it->message.contains("unfinished long"))
+        {
+            // The name of the document rarely changes, so it is only converted, when it does
+            if (chunkName != this->documentName)
+            {
+                this->documentName = chunkName;
+                this->documentNameUtf8 = "=" + chunkName.toUtf8();
+            }
+
+            QString errorString;
+            const int loadResult = this->compile(lua, luaCode.constData(), luaCode.size(), this->documentNameUtf8.constData(), cancelled, errorString);
+
+            if (Q_NULLPTR != cancelled && true == cancelled->load(std::memory_order_relaxed))
+            {
+                result.cancelled = true;
+                return result;
+            }
+
+            if (LUA_ERRMEM == loadResult)
+            {
+                return abortedResult("Syntax check aborted, the script is too large to be checked: " + errorString);
+            }
+
+            if (0 != loadResult)
+            {
+                result.errors = this->collectErrors(lua, luaCode.constData(), luaCode.size(), chunkName, errorString);
+            }
+
+            // Otherwise the split was wrong and the document itself is fine
+            result.valid = true == result.errors.isEmpty();
+            return result;
+        }
+
+        // Errors of the other chunks are collected as well, so that all of them are reported in one check
+        for (const Error& chunkError : it->errors)
+        {
+            Error error = chunkError;
+            error.line += chunk.lineOffset;
+            error.message = this->mapMessage(chunkError.message, chunkName, chunk.lineOffset);
+            result.errors.append(error);
+        }
+    }
+
+    result.valid = true == result.errors.isEmpty();
+
+    if (false == result.valid)
+    {
+        return result;
+    }
+
+    if (true == this->sandboxExecution)
+    {
+        // Optional execution happens in a separate, bounded state, which is thrown away afterwards
+        LuaSandbox luaSandbox(this->sandboxInstructionLimit, static_cast<size_t>(this->sandboxMemoryLimit));
+
+        QString errorString;
+        if (false == luaSandbox.execute(luaCode.toUtf8(), errorString))
+        {
+            Error error;
+            error.line = extractErrorLine(errorString);
+            error.message = errorString;
+
+            result.valid = false;
+            result.errors.append(error);
+        }
+    }
+
+    return result;
+}
+
+LuaSyntaxChecker::Result LuaSyntaxChecker::abortedResult(const QString& reason)
+{
+    Result result;
+    result.valid = false;
+    result.aborted = true;
+
+    Error error;
+    error.message = reason;
+    result.errors.append(error);
+
+    return result;
+}
+
+qint64 LuaSyntaxChecker::getBytesConverted(void) const
+{
+    return this->utf8Reader.getBytesConverted();
+}
+
+qint64 LuaSyntaxChecker::getBytesAllocated(void) const
+{
+    return this->utf8Reader.getBytesAllocated();
+}
+
+void LuaSyntaxChecker::setSandboxExecution(bool sandboxExecution)
+{
+    this->sandboxExecution = sandboxExecution;
+}
+
+bool LuaSyntaxChecker::getSandboxExecution(void) const
+{
+    return this->sandboxExecution;
+}
+
+int LuaSyntaxChecker::extractErrorLine(const QString& errorString)
+{
+    int errorLine = -1;
+
+    // Check for "file:line:message" format
+    QRegularExpression errorRegex(".*:([0-9]+):");
+    QRegularExpressionMatch match = errorRegex.match(errorString);
+
+    if (match.hasMatch())
+    {
+        errorLine = match.captured(1).toInt();
+    }
+
+    // Check for "at line X" in the error message, which wins, if present
+    errorRegex.setPattern("at line ([0-9]+)");
+    match = errorRegex.match(errorString);
+
+    if (match.hasMatch())
+    {
+        errorLine = match.captured(1).toInt();
+    }
+
+    return errorLine;
+}
+
+void LuaSyntaxChecker::splitChunks(const QString& luaCode)
+{
+    // The list keeps its capacity, so that splitting does not allocate from check to check
+    this->chunks.clear();
+
+    const QChar* begin = luaCode.constData();
+    const QChar* end = begin + luaCode.size();
+
+    Chunk chunk;
+    chunk.data = begin;
+
+    int lineNumber = 0;
+
+    for (const QChar* line = begin; line < end; )
+    {
+        // Lines before the first function stay in the first chunk, so that no chunk is empty
+        if (line != chunk.data && true == startsTopLevelFunction(line, end))
+        {
+            chunk.length = line - chunk.data;
+            this->chunks.append(chunk);
+
+            chunk.data = line;
+            chunk.lineOffset = lineNumber;
+        }
+
+        while (line < end && '\n' != line->unicode())
+        {
+            ++line;
+        }
+        if (line < end)
+        {
+            ++line;
+        }
+        ++lineNumber;
+    }
+
+    chunk.length = end - chunk.data;
+    this->chunks.append(chunk);
+}
+
+int LuaSyntaxChecker::compile(lua_State* lua, const QChar* data, qsizetype length, const char* chunkName, const std::atomic_bool* cancelled, QString& errorString)
+{
+    const int loadResult = this->utf8Reader.load(lua, data, length, chunkName, cancelled);
+
+    if (0 != loadResult)
+    {
+        // Get the error message from the Lua stack
+        errorString = QString::fromUtf8(lua_tostring(lua, -1));
+    }
+
+    lua_pop(lua, 1); // Pop the compiled chunk or the error message, the chunk is only needed for validation
+
+    return loadResult;
+}
+
+QString LuaSyntaxChecker::mapMessage(const QString& chunkMessage, const QString& chunkName, int lineOffset) const
+{
+    QString message = chunkMessage;
+
+    // "chunk:3: 'end' expected (to close 'function' at line 1) near 'local'" becomes e.g.
+    // "Scene1_barrel_0.lua:42: 'end' expected (to close 'function' at line 40) near 'local'"
+    QRegularExpression lineRegex("^chunk:([0-9]+):");
+    QRegularExpressionMatch match = lineRegex.match(message);
+
+    if (match.hasMatch())
+    {
+        message.replace(0, match.capturedLength(0), chunkName + ":" + QString::number(match.captured(1).toInt() + lineOffset) + ":");
+    }
+
+    QRegularExpression atLineRegex("at line ([0-9]+)");
+    match = atLineRegex.match(message);
+
+    if (match.hasMatch())
+    {
+        message.replace(match.capturedStart(1), match.capturedLength(1), QString::number(match.captured(1).toInt() + lineOffset));
+    }
+
+    return message;
+}
+
+QList<LuaSyntaxChecker::Error> LuaSyntaxChecker::collectErrors(lua_State* lua, const QChar* data, qsizetype length, const QString& chunkName, const QString& luacMessage)
+{
+    QList<Error> errors;
+
+    Error luacError;
+    luacError.line = extractErrorLine(luacMessage);
+    luacError.message = luacMessage;
+
+    // Without a line, the error cannot be shown, like before
+    if (-1 == luacError.line)
+    {
+        return errors;
+    }
+
+    // The line, at which luac stopped. It differs from the line above for e.g. "'end' expected (to close 'function' at line 3) near '<eof>'"
+    int luacPositionLine = luacError.line;
+    QRegularExpression positionRegex(":([0-9]+):");
+    QRegularExpressionMatch match = positionRegex.match(luacMessage);
+    if (match.hasMatch())
+    {
+        luacPositionLine = match.captured(1).toInt();
+    }
+
+    // luac is the reference for the first error, the recovering parser adds the columns and the errors behind it
+    // The parser needs the whole code at once, it is converted into a buffer, which is reused as well
+    this->utf8Reader.convert(data, length, this->parserBuffer);
+
+    LuaRecoveringParser recoveringParser;
+    const QList<Error> parserErrors = recoveringParser.parse(lua, this->parserBuffer.constData(), static_cast<size_t>(this->parserBuffer.size()), chunkName);
+
+    bool luacErrorAdded = false;
+
+    for (const Error& parserError : parserErrors)
+    {
+        // luac found nothing before its error, so whatever the parser sees there, is wrong
+        if (parserError.line < luacPositionLine)
+        {
+            continue;
+        }
+
+        if (false == luacErrorAdded)
+        {
+            luacErrorAdded = true;
+
+            if (parserError.line == luacPositionLine)
+            {
+                // Same error, luac's wording, the parser's position
+                Error error = parserError;
+                error.message = luacMessage;
+                errors.append(error);
+                continue;
+            }
+
+            errors.append(luacError);
+        }
+
+        errors.append(parserError);
+    }
+
+    if (false == luacErrorAdded)
+    {
+        errors.append(luacError);
+    }
+
+    return errors;
+}
@@ -0,0 +1,102 @@
+#ifndef LUASYNTAXCHECKER_H
+#define LUASYNTAXCHECKER_H
+
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+
+#include <atomic>
+
+#include "backend/luautf8reader.h"
+
+extern "C"
+{
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+}
+
+// Compile-only validation of lua code. The checker has no thread affinity, it works on the lua state it is given,
+// so that the gui thread and the syntax check service can each use their own state.
+// The document is split at top-level function boundaries and the compile result of each chunk is cached by its content hash,
+// so that a keystroke only recompiles the chunk, it touched.
+// The chunks are read by lua straight from the utf16 text through a LuaUtf8Reader, so that a warmed up checker allocates nothing for the code.
+// A chunk, which does not compile, is parsed again by the LuaRecoveringParser, so that all of its errors are reported with their columns.
+class LuaSyntaxChecker
+{
+public:
+    struct Error
+    {
+        int line = -1;
+        int start = 0; // Columns of the offending token, 0 and 0 if only the line is known
+        int end = 0;
+        QString message;
+    };
+
+    struct Result
+    {
+        bool valid = true;
+        QList<Error> errors; // All syntax errors in the order of the code, the first one is the one, luac reports
+        bool cancelled = false;
+        bool aborted = false; // The check could not run to its end, e.g. lua ran out of memory, nothing is known about the code, the reason is the only error
+    };
+public:
+    LuaSyntaxChecker();
+
+    Result check(lua_State* lua, const QString& luaCode, const QString& chunkName, const std::atomic_bool* cancelled = Q_NULLPTR);
+
+    // Not valid and the reason as the only error, so that the file does not look clean
+    static Result abortedResult(const QString& reason);
+
+    void setSandboxExecution(bool sandboxExecution);
+
+    bool getSandboxExecution(void) const;
+
+    // Totals of the utf8 conversion since the checker exists
+    qint64 getBytesConverted(void) const;
+
+    qint64 getBytesAllocated(void) const;
+
+    static int extractErrorLine(const QString& errorString);
+private:
+    // Part of the document, which starts at a top-level function
+    struct Chunk
+    {
+        const QChar* data = Q_NULLPTR;
+        qsizetype length = 0;
+        int lineOffset = 0; // Count of document lines before the chunk
+    };
+
+    struct ChunkResult
+    {
+        bool valid = true;
+        bool endsBlock = false; // Valid, but ends with a top-level return, so no chunk may follow
+        QString text; // The chunk, a hit of its hash only counts, if the text is the same
+        QString message; // Relative to the chunk, e.g. "chunk:3: 'end' expected near 'local'"
+        QList<Error> errors; // Relative to the chunk as well
+    };
+private:
+    void splitChunks(const QString& luaCode);
+
+    int compile(lua_State* lua, const QChar* data, qsizetype length, const char* chunkName, const std::atomic_bool* cancelled, QString& errorString);
+
+    QString mapMessage(const QString& chunkMessage, const QString& chunkName, int lineOffset) const;
+
+    QList<Error> collectErrors(lua_State* lua, const QChar* data, qsizetype length, const QString& chunkName, const QString& luacMessage);
+private:
+    QHash<quint64, ChunkResult> chunkResults; // Compile results by chunk content hash, a collision just compiles again
+    QList<Chunk> chunks; // Chunks of the last check, kept for their capacity
+    LuaUtf8Reader utf8Reader;
+    QByteArray parserBuffer; // Utf8 code for the LuaRecoveringParser
+    QString probeBuffer; // A chunk with a statement appended, to find out, whether it ends with a return
+    QString documentName;
+    QByteArray documentNameUtf8; // "=" + documentName, as lua wants it
+    bool sandboxExecution; // Whether a successfully compiled script is additionally executed in a bounded LuaSandbox
+    int sandboxInstructionLimit;
+    qint64 sandboxMemoryLimit;
+};
+
+Q_DECLARE_METATYPE(LuaSyntaxChecker::Result)
+
+#endif // LUASYNTAXCHECKER_H
@@ -0,0 +1,146 @@
+#include "backend/luautf8reader.h"
+
+namespace
+{
+    // Longest utf8 sequence of one code point
+    const int maxSequenceLength = 4;
+}
+
+LuaUtf8Reader::LuaUtf8Reader(int blockSize)
+    : data(Q_NULLPTR),
+    length(0),
+    position(0),
+    cancelled(Q_NULLPTR),
+    bytesConverted(0),
+    bytesAllocated(0)
+{
+    this->buffer.resize(qMax(blockSize, maxSequenceLength));
+    this->bytesAllocated += this->buffer.capacity();
+}
+
+int LuaUtf8Reader::load(lua_State* lua, const QChar* data, qsizetype length, const char* chunkName, const std::atomic_bool* cancelled)
+{
+    this->data = data;
+    this->length = length;
+    this->position = 0;
+    this->cancelled = cancelled;
+
+    const int result = lua_load(lua, &LuaUtf8Reader::readBlock, this, chunkName);
+
+    this->data = Q_NULLPTR;
+    this->cancelled = Q_NULLPTR;
+
+    return result;
+}
+
+void LuaUtf8Reader::convert(const QChar* data, qsizetype length, QByteArray& target)
+{
+    // 3 bytes per utf16 unit is the worst case, a surrogate pair takes 4 bytes for 2 units.
+    // encode only writes, while a whole sequence fits, so there must be room for one more at the end.
+    const qsizetype oldCapacity = target.capacity();
+    target.resize(length * 3 + maxSequenceLength);
+    if (target.capacity() > oldCapacity)
+    {
+        this->bytesAllocated += target.capacity() - oldCapacity;
+    }
+
+    qsizetype position = 0;
+    qsizetype written = 0;
+
+    while (position < length)
+    {
+        // The buffer is large enough, encode just works in portions, which fit into an int
+        const int capacity = static_cast<int>(qMin(target.size() - written, static_cast<qsizetype>(1 << 30)));
+        const int portion = encode(data, length, position, target.data() + written, capacity);
+        if (0 == portion)
+        {
+            // Can not happen with the size above, but must never spin
+            break;
+        }
+        written += portion;
+    }
+
+    // Shrinking keeps the capacity
+    target.resize(written);
+    this->bytesConverted += written;
+}
+
+qint64 LuaUtf8Reader::getBytesConverted(void) const
+{
+    return this->bytesConverted;
+}
+
+qint64 LuaUtf8Reader::getBytesAllocated(void) const
+{
+    return this->bytesAllocated;
+}
+
+const char* LuaUtf8Reader::readBlock(lua_State* lua, void* userData, size_t* size)
+{
+    Q_UNUSED(lua)
+
+    LuaUtf8Reader* reader = static_cast<LuaUtf8Reader*>(userData);
+
+    // Lua asks for the code block by block, which gives a running check the chance to stop early, if it became stale
+    if ((Q_NULLPTR != reader->cancelled && true == reader->cancelled->load(std::memory_order_relaxed)) || reader->position >= reader->length)
+    {
+        *size = 0;
+        return Q_NULLPTR;
+    }
+
+    // Lua is done with the last block, when it asks for the next one, so the buffer can be overwritten
+    const int written = encode(reader->data, reader->length, reader->position, reader->buffer.data(), static_cast<int>(reader->buffer.size()));
+    reader->bytesConverted += written;
+
+    *size = static_cast<size_t>(written);
+    return reader->buffer.constData();
+}
+
+int LuaUtf8Reader::encode(const QChar* data, qsizetype length, qsizetype& position, char* target, int capacity)
+{
+    int written = 0;
+
+    while (position < length && written + maxSequenceLength <= capacity)
+    {
+        char32_t codePoint = data[position].unicode();
+        ++position;
+
+        if (codePoint < 0x80)
+        {
+            target[written++] = static_cast<char>(codePoint);
+            continue;
+        }
+
+        if (QChar::isHighSurrogate(codePoint) && position < length && true == data[position].isLowSurrogate())
+        {
+            codePoint = QChar::surrogateToUcs4(static_cast<char16_t>(codePoint), data[position].unicode());
+            ++position;
+        }
+        else if (QChar::isSurrogate(codePoint))
+        {
+            // A lone surrogate becomes the replacement character, like in QString::toUtf8
+            codePoint = QChar::ReplacementCharacter;
+        }
+
+        if (codePoint < 0x800)
+        {
+            target[written++] = static_cast<char>(0xC0 | (codePoint >> 6));
+            target[written++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000)
+        {
+            target[written++] = static_cast<char>(0xE0 | (codePoint >> 12));
+            target[written++] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            target[written++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            target[written++] = static_cast<char>(0xF0 | (codePoint >> 18));
+            target[written++] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            target[written++] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            target[written++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    return written;
+}
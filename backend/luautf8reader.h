@@ -0,0 +1,46 @@
+#ifndef LUAUTF8READER_H
+#define LUAUTF8READER_H
+
+#include <QString>
+#include <QByteArray>
+
+#include <atomic>
+
+extern "C"
+{
+#include <lua.h>
+}
+
+// Hands the utf16 text of the editor to lua_load without converting the whole text first.
+// The text is converted to utf8 block by block into one buffer, which is reused for every block and every load,
+// so that loading allocates nothing, once the buffer exists.
+class LuaUtf8Reader
+{
+public:
+    explicit LuaUtf8Reader(int blockSize = 64 * 1024);
+
+    // Same as lua_load, but for utf16 text. A set cancelled flag ends the input early.
+    int load(lua_State* lua, const QChar* data, qsizetype length, const char* chunkName, const std::atomic_bool* cancelled = Q_NULLPTR);
+
+    // Converts the whole text into target, whose capacity is reused, for code that needs the utf8 text at once
+    void convert(const QChar* data, qsizetype length, QByteArray& target);
+
+    qint64 getBytesConverted(void) const;
+
+    qint64 getBytesAllocated(void) const;
+private:
+    static const char* readBlock(lua_State* lua, void* userData, size_t* size);
+
+    // Converts as much as fits into target, a surrogate pair is never split. Returns the count of written bytes.
+    static int encode(const QChar* data, qsizetype length, qsizetype& position, char* target, int capacity);
+private:
+    QByteArray buffer;
+    const QChar* data;
+    qsizetype length;
+    qsizetype position;
+    const std::atomic_bool* cancelled;
+    qint64 bytesConverted;
+    qint64 bytesAllocated;
+};
+
+#endif // LUAUTF8READER_H
@@ -0,0 +1,174 @@
+#include "backend/messagejournal.h"
+
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+
+namespace
+{
+    // The first frame, its size, type and sequence and the start of its content, differs between two journals
+    const qint64 headSize = 64;
+}
+
+MessageJournal::MessageJournal(const QString& journalFilePathName, QObject* parent)
+    : QObject(parent),
+    journalFilePathName(journalFilePathName),
+    readOffset(0),
+    lastSequence(0)
+{
+    // The folder tells, when the journal is created, the file itself, when something has been appended. It can only be watched, if it exists.
+    const QString journalFolder = QFileInfo(journalFilePathName).absolutePath();
+    QDir().mkpath(journalFolder);
+    this->fileWatcher.addPath(journalFolder);
+
+    connect(&this->fileWatcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString& path)
+            {
+                Q_UNUSED(path)
+                this->watchJournal();
+            });
+
+    connect(&this->fileWatcher, &QFileSystemWatcher::fileChanged, this, [this](const QString& path)
+            {
+                Q_UNUSED(path)
+                this->readNewEntries();
+                // Some writers replace the file, which ends the watch
+                this->watchJournal();
+            });
+
+    this->watchJournal();
+}
+
+void MessageJournal::readNewEntries(void)
+{
+    QFile file(this->journalFilePathName);
+
+    if (false == file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    const qint64 size = file.size();
+
+    if (true == this->isRecreated(file, size))
+    {
+        // A new journal has been started, it may already be larger than the old one
+        this->reset();
+    }
+
+    if (0 == this->readOffset)
+    {
+        this->birthTime = QFileInfo(file).birthTime();
+    }
+
+    if (this->head.size() < headSize && size > this->head.size())
+    {
+        file.seek(0);
+        this->head = file.read(headSize);
+    }
+
+    if (size == this->readOffset)
+    {
+        return;
+    }
+
+    file.seek(this->readOffset);
+    const QByteArray newBytes = file.read(size - this->readOffset);
+    file.close();
+
+    this->readOffset += newBytes.size();
+
+    // A frame, which is still being written, stays in the reader until the rest arrives
+    this->frameReader.append(newBytes);
+
+    IpcProtocol::Message message;
+
+    while (true == this->frameReader.next(message))
+    {
+        if (message.sequence == this->lastSequence && 0 != message.sequence)
+        {
+            // Written twice
+            continue;
+        }
+
+        if (message.sequence < this->lastSequence)
+        {
+            // NOWA-Design has been restarted and appends to the journal of its last run, its sequence starts over
+            qDebug() << "Message journal sequence started over:" << this->lastSequence << "->" << message.sequence;
+        }
+
+        this->lastSequence = message.sequence;
+
+        Q_EMIT signal_messageReceived(message);
+    }
+
+    if (true == this->frameReader.hasError())
+    {
+        // Cannot be resynchronized, the entries so far are dropped and only new ones are read
+        qWarning() << "Broken message journal:" << this->journalFilePathName << this->frameReader.getErrorString();
+        this->frameReader = IpcProtocol::FrameReader();
+    }
+}
+
+void MessageJournal::remove(void)
+{
+    if (true == QFile::remove(this->journalFilePathName))
+    {
+        qDebug() << "Message journal deleted successfully.";
+    }
+
+    this->reset();
+}
+
+QString MessageJournal::getJournalFilePathName(void) const
+{
+    return this->journalFilePathName;
+}
+
+quint32 MessageJournal::getLastSequence(void) const
+{
+    return this->lastSequence;
+}
+
+void MessageJournal::watchJournal(void)
+{
+    if (false == this->fileWatcher.files().contains(this->journalFilePathName) && true == QFileInfo::exists(this->journalFilePathName))
+    {
+        this->fileWatcher.addPath(this->journalFilePathName);
+
+        // Entries may have been written, before the watch started
+        this->readNewEntries();
+    }
+}
+
+void MessageJournal::reset(void)
+{
+    this->readOffset = 0;
+    this->lastSequence = 0;
+    this->frameReader = IpcProtocol::FrameReader();
+    this->birthTime = QDateTime();
+    this->head.clear();
+}
+
+bool MessageJournal::isRecreated(QFile& file, qint64 size) const
+{
+    if (0 == this->readOffset)
+    {
+        return false;
+    }
+
+    if (size < this->readOffset)
+    {
+        return true;
+    }
+
+    // Not every file system tells the creation time
+    const QDateTime currentBirthTime = QFileInfo(file).birthTime();
+    if (true == this->birthTime.isValid() && true == currentBirthTime.isValid() && this->birthTime != currentBirthTime)
+    {
+        return true;
+    }
+
+    // The bytes read so far must not have changed
+    file.seek(0);
+    return this->head != file.read(this->head.size());
+}
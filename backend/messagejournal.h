@@ -0,0 +1,55 @@
+#ifndef MESSAGEJOURNAL_H
+#define MESSAGEJOURNAL_H
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+
+#include "backend/ipcprotocol.h"
+
+// Append only file, into which NOWA-Design writes its messages as IpcProtocol frames, e.g. when the ipc channel is not connected.
+// The sequence of the frames increases monotonically. Only the bytes appended since the last read are read, so that a burst of
+// change notifications for one write costs one read of the new entries. A repeated entry is skipped, a sequence, which goes back,
+// means, that the writer started over, its entries are delivered. If the journal is recreated, which is told by its creation time
+// and its first bytes and not only by a smaller size, it is read again from the start.
+class MessageJournal : public QObject
+{
+    Q_OBJECT
+public:
+    // In a folder of its own, appending to it must not wake up the watch of the xml folder
+    static inline const QString defaultFilePathName = QString(TARGET_PATH) + "/NOWALuaScript/bin/journal/lua_script_messages.journal";
+public:
+    // The folder of the journal is created, if it does not exist
+    explicit MessageJournal(const QString& journalFilePathName = MessageJournal::defaultFilePathName, QObject* parent = Q_NULLPTR);
+
+    // Reads the entries, which have been appended since the last read
+    void readNewEntries(void);
+
+    // Removes the journal, e.g. when the editor quits, so that the next start does not deliver old messages again
+    void remove(void);
+
+    QString getJournalFilePathName(void) const;
+
+    quint32 getLastSequence(void) const;
+Q_SIGNALS:
+    void signal_messageReceived(const IpcProtocol::Message& message);
+private:
+    void watchJournal(void);
+
+    void reset(void);
+
+    bool isRecreated(QFile& file, qint64 size) const;
+private:
+    QString journalFilePathName;
+    QFileSystemWatcher fileWatcher;
+    IpcProtocol::FrameReader frameReader;
+    qint64 readOffset;
+    quint32 lastSequence;
+    // Identity of the journal, which is being read
+    QDateTime birthTime;
+    QByteArray head;
+};
+
+#endif // MESSAGEJOURNAL_H
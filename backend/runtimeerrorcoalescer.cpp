@@ -0,0 +1,130 @@
+#include "backend/runtimeerrorcoalescer.h"
+
+#include <QDateTime>
+
+namespace
+{
+    // Distinct errors, which are remembered. A game with more broken lines than this has other problems.
+    const int maxEntries = 512;
+}
+
+RuntimeErrorCoalescer::RuntimeErrorCoalescer(int flushIntervalMs, QObject* parent)
+    : QObject(parent)
+{
+    this->flushTimer.setSingleShot(true);
+    this->flushTimer.setInterval(flushIntervalMs);
+    connect(&this->flushTimer, &QTimer::timeout, this, &RuntimeErrorCoalescer::flush);
+}
+
+void RuntimeErrorCoalescer::report(const QString& filePathName, const QString& errorMessage, int line, int start, int end, int hitCount)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    Key key;
+    key.filePathName = QString(filePathName).replace("\\", "/");
+    key.line = line;
+    key.errorMessage = errorMessage;
+
+    auto it = this->entries.find(key);
+    if (this->entries.end() == it)
+    {
+        Entry entry;
+        entry.filePathName = key.filePathName;
+        entry.errorMessage = errorMessage;
+        entry.line = line;
+        entry.firstTimestamp = now;
+        it = this->entries.insert(key, entry);
+    }
+
+    Entry& entry = it.value();
+    entry.start = start;
+    entry.end = end;
+    entry.hitCount += static_cast<quint64>(qMax(1, hitCount));
+    entry.lastTimestamp = now;
+
+    if (false == this->flushTimer.isActive())
+    {
+        // First report after a quiet interval, no reason to wait
+        const Entry delivered = entry;
+        this->evict();
+        this->flushTimer.start();
+        Q_EMIT signal_runtimeErrorCoalesced(delivered);
+        return;
+    }
+
+    if (false == this->dirtyKeys.contains(key))
+    {
+        this->dirtyKeys.append(key);
+    }
+
+    this->evict();
+}
+
+void RuntimeErrorCoalescer::clear(const QString& filePathName)
+{
+    const QString normalizedFilePathName = QString(filePathName).replace("\\", "/");
+
+    for (auto it = this->entries.begin(); it != this->entries.end();)
+    {
+        if (it.key().filePathName == normalizedFilePathName)
+        {
+            it = this->entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    this->dirtyKeys.removeIf([&normalizedFilePathName](const Key& key)
+                             {
+                                 return key.filePathName == normalizedFilePathName;
+                             });
+}
+
+QList<RuntimeErrorCoalescer::Entry> RuntimeErrorCoalescer::getEntries(void) const
+{
+    return this->entries.values();
+}
+
+void RuntimeErrorCoalescer::flush(void)
+{
+    if (true == this->dirtyKeys.isEmpty())
+    {
+        // Quiet interval, the next report is delivered right away again
+        return;
+    }
+
+    const QList<Key> keys = this->dirtyKeys;
+    this->dirtyKeys.clear();
+
+    // Further reports during this interval are collected for the next flush
+    this->flushTimer.start();
+
+    for (const Key& key : keys)
+    {
+        auto it = this->entries.constFind(key);
+        if (this->entries.constEnd() != it)
+        {
+            Q_EMIT signal_runtimeErrorCoalesced(it.value());
+        }
+    }
+}
+
+void RuntimeErrorCoalescer::evict(void)
+{
+    while (this->entries.size() > maxEntries)
+    {
+        auto oldest = this->entries.begin();
+        for (auto it = this->entries.begin(); it != this->entries.end(); ++it)
+        {
+            if (it.value().lastTimestamp < oldest.value().lastTimestamp)
+            {
+                oldest = it;
+            }
+        }
+
+        this->dirtyKeys.removeOne(oldest.key());
+        this->entries.erase(oldest);
+    }
+}
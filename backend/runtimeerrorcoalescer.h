@@ -0,0 +1,68 @@
+#ifndef RUNTIMEERRORCOALESCER_H
+#define RUNTIMEERRORCOALESCER_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+
+// Coalesces runtime errors of the game before they reach the editor. A script, which breaks in update(dt), reports the same
+// error on every frame. Reports with the same file, line and message are counted into one entry with the first and last time.
+// The first report of a burst is delivered right away, all further reports within flushIntervalMs are delivered together at
+// the end of the interval, one delivery per entry. So an error repeated 60 times per second costs a few ui updates per second.
+class RuntimeErrorCoalescer : public QObject
+{
+    Q_OBJECT
+public:
+    struct Entry
+    {
+        QString filePathName;
+        QString errorMessage;
+        int line = -1;
+        int start = -1;
+        int end = -1;
+        quint64 hitCount = 0;
+        qint64 firstTimestamp = 0; // ms since epoch
+        qint64 lastTimestamp = 0;
+    };
+public:
+    explicit RuntimeErrorCoalescer(int flushIntervalMs = 250, QObject* parent = Q_NULLPTR);
+
+    // hitCount is more than 1, if the source has already collapsed equal reports, e.g. the DiagnosticsRing
+    void report(const QString& filePathName, const QString& errorMessage, int line, int start, int end, int hitCount = 1);
+
+    // Forgets the entries of the script, e.g. when its tab is closed, so that the next report is delivered as a new error
+    void clear(const QString& filePathName);
+
+    QList<Entry> getEntries(void) const;
+Q_SIGNALS:
+    void signal_runtimeErrorCoalesced(const RuntimeErrorCoalescer::Entry& entry);
+private Q_SLOTS:
+    void flush(void);
+private:
+    struct Key
+    {
+        QString filePathName;
+        int line;
+        QString errorMessage;
+
+        bool operator==(const Key& other) const
+        {
+            return this->line == other.line && this->filePathName == other.filePathName && this->errorMessage == other.errorMessage;
+        }
+
+        friend size_t qHash(const Key& key, size_t seed)
+        {
+            return qHashMulti(seed, key.filePathName, key.line, key.errorMessage);
+        }
+    };
+
+    // Removes the entries, which have not been hit for the longest time, if there are too many
+    void evict(void);
+private:
+    QHash<Key, Entry> entries;
+    QList<Key> dirtyKeys;
+    QTimer flushTimer;
+};
+
+#endif // RUNTIMEERRORCOALESCER_H
@@ -0,0 +1,116 @@
+#include "backend/saveservice.h"
+
+#include <QSaveFile>
+#include <QMutexLocker>
+#include <QDebug>
+
+SaveService::SaveService(QObject* parent)
+    : QObject(parent)
+{
+    // Results are delivered with a queued connection
+    qRegisterMetaType<SaveService::Result>("SaveService::Result");
+}
+
+SaveService::~SaveService()
+{
+    this->threadPool.waitForDone();
+}
+
+void SaveService::requestSave(const QString& filePathName, const QString& content)
+{
+    QMutexLocker lock(&this->mutex);
+
+    // A waiting save of the same file is outdated now, it keeps the time of its request, so that the latency stays honest
+    auto it = this->pendingRequests.find(filePathName);
+    if (this->pendingRequests.end() != it)
+    {
+        it->content = content;
+        ++it->coalescedCount;
+        return;
+    }
+
+    SaveRequest& saveRequest = this->pendingRequests[filePathName];
+    saveRequest.content = content;
+    saveRequest.requestTimer.start();
+
+    // The thread, which writes the file right now, takes the request, when it is done
+    if (true == this->runningFilePathNames.contains(filePathName))
+    {
+        return;
+    }
+
+    this->runningFilePathNames.insert(filePathName);
+
+    this->threadPool.start([this, filePathName]
+        {
+            this->run(filePathName);
+        });
+}
+
+SaveService::Result SaveService::writeFile(const QString& filePathName, const QString& content)
+{
+    Result result;
+    result.filePathName = filePathName;
+    result.content = content;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QSaveFile file(filePathName);
+
+    if (false == file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        result.message = "Failed to save lua script: \n" + filePathName + " Error: " + file.errorString();
+        return result;
+    }
+
+    const QByteArray luaCode = content.toUtf8();
+
+    if (luaCode.size() != file.write(luaCode))
+    {
+        result.message = "Failed to save lua script: \n" + filePathName + " Error: " + file.errorString();
+        // Not committed, the temporary file is discarded and the script stays as it was
+        return result;
+    }
+
+    // Renames the temporary file over the script, until then the old content stays untouched
+    if (false == file.commit())
+    {
+        result.message = "Failed to save lua script: \n" + filePathName + " Error: " + file.errorString();
+        return result;
+    }
+
+    result.success = true;
+    result.bytesWritten = luaCode.size();
+    result.writeTimeMs = timer.nsecsElapsed() / 1000000.0;
+
+    return result;
+}
+
+void SaveService::run(const QString& filePathName)
+{
+    while (true)
+    {
+        SaveRequest saveRequest;
+
+        {
+            QMutexLocker lock(&this->mutex);
+
+            auto it = this->pendingRequests.find(filePathName);
+            if (this->pendingRequests.end() == it)
+            {
+                this->runningFilePathNames.remove(filePathName);
+                return;
+            }
+
+            saveRequest = it.value();
+            this->pendingRequests.erase(it);
+        }
+
+        Result result = writeFile(filePathName, saveRequest.content);
+        result.latencyMs = saveRequest.requestTimer.nsecsElapsed() / 1000000.0;
+        result.coalescedCount = saveRequest.coalescedCount;
+
+        Q_EMIT signal_saveFinished(result);
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef SAVESERVICE_H
+#define SAVESERVICE_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QMutex>
+#include <QHash>
+#include <QSet>
+#include <QElapsedTimer>
+
+// Saves scripts on a thread pool, so that saving never blocks typing. Each file is written with QSaveFile, which writes
+// into a temporary file and renames it over the script, so that NOWA-Design, which polls the scripts, never reads a torn file.
+// Saves of different files run in parallel, e.g. when all tabs are saved. A file is written by one thread at a time,
+// a save requested meanwhile replaces the one waiting for the file, so that only the latest content is written.
+class SaveService : public QObject
+{
+    Q_OBJECT
+public:
+    struct Result
+    {
+        QString filePathName;
+        QString content; // The content, which has been written
+        bool success = false;
+        qint64 bytesWritten = 0;
+        double writeTimeMs = 0.0; // Writing and renaming
+        double latencyMs = 0.0; // From the request until the file has been renamed
+        int coalescedCount = 0; // Count of requests, which have been replaced by this one
+        QString message;
+    };
+public:
+    explicit SaveService(QObject* parent = Q_NULLPTR);
+
+    // Waits for the saves, which are still running, so that nothing is lost on exit
+    virtual ~SaveService();
+
+    void requestSave(const QString& filePathName, const QString& content);
+
+    // Writes the content atomically, can be called from any thread
+    static Result writeFile(const QString& filePathName, const QString& content);
+Q_SIGNALS:
+    // Emitted from a pool thread, use a queued connection
+    void signal_saveFinished(const SaveService::Result& result);
+private:
+    struct SaveRequest
+    {
+        QString content;
+        QElapsedTimer requestTimer;
+        int coalescedCount = 0;
+    };
+private:
+    void run(const QString& filePathName);
+private:
+    QThreadPool threadPool;
+    QMutex mutex;
+    QHash<QString, SaveRequest> pendingRequests;
+    QSet<QString> runningFilePathNames;
+};
+
+#endif // SAVESERVICE_H
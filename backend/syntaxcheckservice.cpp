@@ -0,0 +1,145 @@
+#include "backend/syntaxcheckservice.h"
+#include "backend/luastatepool.h"
+
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QDebug>
+
+SyntaxCheckService::SyntaxCheckService(QObject* parent)
+    : QObject(parent),
+    workerThread(Q_NULLPTR),
+    cancelRunning(false),
+    stopped(false)
+{
+    // Results are delivered with a queued connection
+    qRegisterMetaType<LuaSyntaxChecker::Result>("LuaSyntaxChecker::Result");
+
+    this->workerThread = QThread::create([this]
+        {
+            this->run();
+        });
+
+    this->workerThread->start();
+}
+
+SyntaxCheckService::~SyntaxCheckService()
+{
+    {
+        QMutexLocker lock(&this->mutex);
+        this->stopped = true;
+        this->cancelRunning = true;
+        this->condition.wakeAll();
+    }
+
+    this->workerThread->wait();
+    delete this->workerThread;
+}
+
+quint64 SyntaxCheckService::requestCheck(const QString& filePathName, const QString& luaCode)
+{
+    QMutexLocker lock(&this->mutex);
+
+    const quint64 revision = this->latestRevisions.value(filePathName, 0) + 1;
+    this->latestRevisions[filePathName] = revision;
+
+    // A queued request for the same file is just replaced, it keeps its place in the queue
+    if (false == this->pendingRequests.contains(filePathName))
+    {
+        this->queue.append(filePathName);
+    }
+
+    CheckRequest& checkRequest = this->pendingRequests[filePathName];
+    checkRequest.filePathName = filePathName;
+    checkRequest.luaCode = luaCode;
+    checkRequest.revision = revision;
+
+    // The running check is outdated now
+    if (this->runningFilePathName == filePathName)
+    {
+        this->cancelRunning = true;
+    }
+
+    this->condition.wakeOne();
+
+    return revision;
+}
+
+void SyntaxCheckService::cancel(const QString& filePathName)
+{
+    QMutexLocker lock(&this->mutex);
+
+    this->queue.removeAll(filePathName);
+    this->pendingRequests.remove(filePathName);
+    this->latestRevisions.remove(filePathName);
+
+    if (this->runningFilePathName == filePathName)
+    {
+        this->cancelRunning = true;
+    }
+}
+
+bool SyntaxCheckService::isCurrent(const QString& filePathName, quint64 revision) const
+{
+    QMutexLocker lock(&this->mutex);
+
+    return this->latestRevisions.value(filePathName, 0) == revision;
+}
+
+void SyntaxCheckService::run(void)
+{
+    // The checker keeps its cache for the whole service, the lua state is only borrowed from the pool for each check
+    LuaSyntaxChecker luaSyntaxChecker;
+
+    while (true)
+    {
+        CheckRequest checkRequest;
+
+        {
+            QMutexLocker lock(&this->mutex);
+
+            while (false == this->stopped && true == this->queue.isEmpty())
+            {
+                this->condition.wait(&this->mutex);
+            }
+
+            if (true == this->stopped)
+            {
+                break;
+            }
+
+            const QString filePathName = this->queue.takeFirst();
+            checkRequest = this->pendingRequests.take(filePathName);
+
+            this->runningFilePathName = filePathName;
+            this->cancelRunning = false;
+        }
+
+        LuaSyntaxChecker::Result result;
+
+        lua_State* lua = LuaStatePool::instance()->acquire();
+        if (Q_NULLPTR != lua)
+        {
+            result = luaSyntaxChecker.check(lua, checkRequest.luaCode, QFileInfo(checkRequest.filePathName).fileName(), &this->cancelRunning);
+
+            LuaStatePool::instance()->release(lua);
+        }
+        else
+        {
+            // Else the errors of the last check would stay in the editor, as if they were current
+            result = LuaSyntaxChecker::abortedResult("Syntax check aborted, no lua state could be created.");
+        }
+
+        {
+            QMutexLocker lock(&this->mutex);
+            this->runningFilePathName.clear();
+        }
+
+        // A cancelled or meanwhile outdated result is not delivered at all
+        if (true == result.cancelled || false == this->isCurrent(checkRequest.filePathName, checkRequest.revision))
+        {
+            continue;
+        }
+
+        Q_EMIT signal_checkFinished(checkRequest.filePathName, checkRequest.revision, result);
+    }
+}
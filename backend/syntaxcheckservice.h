@@ -0,0 +1,58 @@
+#ifndef SYNTAXCHECKSERVICE_H
+#define SYNTAXCHECKSERVICE_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QHash>
+#include <QList>
+
+#include "backend/luasyntaxchecker.h"
+
+#include <atomic>
+
+// Runs syntax checks on a single worker thread, so that compiling a large script never blocks the gui.
+// Requests are keyed by file path name and a document revision. A newer request for a file replaces a queued one
+// and cancels a running one, so that only the latest revision of each file is checked.
+class SyntaxCheckService : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SyntaxCheckService(QObject* parent = Q_NULLPTR);
+
+    virtual ~SyntaxCheckService();
+
+    // Queues a check of the given code and returns the revision, the result will carry
+    quint64 requestCheck(const QString& filePathName, const QString& luaCode);
+
+    // Drops a queued and cancels a running check, e.g. if the file has been closed
+    void cancel(const QString& filePathName);
+
+    // Whether the revision is still the latest one requested for the file
+    bool isCurrent(const QString& filePathName, quint64 revision) const;
+Q_SIGNALS:
+    // Emitted from the worker thread, use a queued connection
+    void signal_checkFinished(const QString& filePathName, quint64 revision, const LuaSyntaxChecker::Result& result);
+private:
+    struct CheckRequest
+    {
+        QString filePathName;
+        QString luaCode;
+        quint64 revision = 0;
+    };
+private:
+    void run(void);
+private:
+    QThread* workerThread;
+    mutable QMutex mutex;
+    QWaitCondition condition;
+    QList<QString> queue; // File path names in the order they have been requested
+    QHash<QString, CheckRequest> pendingRequests;
+    QHash<QString, quint64> latestRevisions;
+    QString runningFilePathName;
+    std::atomic_bool cancelRunning;
+    bool stopped;
+};
+
+#endif // SYNTAXCHECKSERVICE_H
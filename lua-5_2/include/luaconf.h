@@ -287,7 +287,9 @@
 ** mean larger pauses which mean slower collection.) You can also change
 ** this value dynamically.
 */
+#if !defined(LUAI_GCPAUSE)
 #define LUAI_GCPAUSE	200  /* 200% (wait memory to double before next GC) */
+#endif
 
 
 /*
@@ -298,7 +300,9 @@
 ** infinity, where each step performs a full collection.) You can also
 ** change this value dynamically.
 */
+#if !defined(LUAI_GCMUL)
 #define LUAI_GCMUL	200 /* GC runs 'twice the speed' of memory allocation */
+#endif
 
 
 
@@ -420,7 +424,9 @@
 ** arbitrary; its only purpose is to stop infinite recursion before
 ** exhausting memory.
 */
+#if !defined(LUAI_MAXCALLS)
 #define LUAI_MAXCALLS	20000
+#endif
 
 
 /*
@@ -430,7 +436,9 @@
 ** functions. This limit is arbitrary; its only purpose is to stop C
 ** functions to consume unlimited stack space.
 */
+#if !defined(LUAI_MAXCSTACK)
 #define LUAI_MAXCSTACK	2048
+#endif
 
 
 
@@ -452,27 +460,35 @@
 @@ LUAI_MAXCCALLS is the maximum depth for nested C calls (short) and
 @* syntactical nested non-terminals in a program.
 */
+#if !defined(LUAI_MAXCCALLS)
 #define LUAI_MAXCCALLS		200
+#endif
 
 
 /*
 @@ LUAI_MAXVARS is the maximum number of local variables per function
 @* (must be smaller than 250).
 */
+#if !defined(LUAI_MAXVARS)
 #define LUAI_MAXVARS		200
+#endif
 
 
 /*
 @@ LUAI_MAXUPVALUES is the maximum number of upvalues per function
 @* (must be smaller than 250).
 */
+#if !defined(LUAI_MAXUPVALUES)
 #define LUAI_MAXUPVALUES	60
+#endif
 
 
 /*
 @@ LUAL_BUFFERSIZE is the buffer size used by the lauxlib buffer system.
 */
+#if !defined(LUAL_BUFFERSIZE)
 #define LUAL_BUFFERSIZE		BUFSIZ
+#endif
 
 /* }================================================================== */
 
@@ -1,4 +1,5 @@
 #include "luascriptadapter.h"
+#include "backend/luabytecodecompiler.h"
 
 #include <QDebug>
 
@@ -9,6 +10,8 @@
 #include <QSettings>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
+#include <QElapsedTimer>
+#include <QtConcurrent>
 
 namespace
 {
@@ -32,13 +35,70 @@ namespace
 
 LuaScriptAdapter::LuaScriptAdapter(QObject* parent)
     : QObject{parent},
-    luaApiCreatedIntially(false)
+    luaApiCreatedIntially(false),
+    syntaxCheckService(Q_NULLPTR),
+    saveService(Q_NULLPTR)
 {
+    this->syntaxCheckService = new SyntaxCheckService(this);
 
+    // Results arrive from the worker thread. Only the result of the latest revision of a file is relayed, everything older is stale
+    connect(this->syntaxCheckService, &SyntaxCheckService::signal_checkFinished, this, [this](const QString& filePathName, quint64 revision, const LuaSyntaxChecker::Result& result)
+            {
+                if (false == this->syntaxCheckService->isCurrent(filePathName, revision) || -1 == this->findLuaScript(filePathName))
+                {
+                    return;
+                }
+
+                // Clears the errors of the last check, each error is then delivered on its own
+                Q_EMIT signal_syntaxCheckResult(filePathName, true, -1, 0, 0, "");
+
+                for (const LuaSyntaxChecker::Error& error : result.errors)
+                {
+                    Q_EMIT signal_syntaxCheckResult(filePathName, false, error.line, error.start, error.end, error.message);
+                }
+            }, Qt::QueuedConnection);
+
+    this->saveService = new SaveService(this);
+
+    // Saves finish on a pool thread
+    connect(this->saveService, &SaveService::signal_saveFinished, this, [this](const SaveService::Result& result)
+            {
+                if (false == result.success)
+                {
+                    qWarning() << result.message;
+                    // The script keeps its changes, so that the user can save again
+                    Q_EMIT signal_luaScriptSaveFailed(result.filePathName, result.message);
+                    return;
+                }
+
+                qDebug() << "Lua script saved:" << result.filePathName << "bytes:" << result.bytesWritten << "write ms:" << result.writeTimeMs
+                         << "latency ms:" << result.latencyMs << "coalesced:" << result.coalescedCount;
+
+                Q_EMIT signal_luaScriptSaved(result.filePathName, result.content);
+
+                QSettings settings("NOWA", "NOWALuaScript");
+
+                // The bytecode is compiled in the background, saving does not wait for it
+                if (true == settings.value("CompileOnSave", false).toBool())
+                {
+                    const bool stripDebugInfo = settings.value("StripDebugInfo", false).toBool();
+                    const QString savedFilePathName = result.filePathName;
+                    const QByteArray luaCode = result.content.toUtf8();
+
+                    this->compilePool.start([this, savedFilePathName, luaCode, stripDebugInfo]
+                        {
+                            const LuaBytecodeCompiler::Result result = LuaBytecodeCompiler::compile(savedFilePathName, luaCode, stripDebugInfo);
+
+                            Q_EMIT signal_bytecodeCompileResult(result.filePathName, result.success, result.sourceSize, result.bytecodeSize, result.compileTimeMs, result.message);
+                        });
+                }
+            }, Qt::QueuedConnection);
 }
 
 LuaScriptAdapter::~LuaScriptAdapter()
 {
+    this->compilePool.waitForDone();
+
     for (const auto& luaScript : this->luaScripts)
     {
         luaScript->deleteLater();
@@ -46,7 +106,7 @@ LuaScriptAdapter::~LuaScriptAdapter()
     this->luaScripts.clear();
 }
 
-QPair<int, LuaEditorModelItem*> LuaScriptAdapter::createLuaScript(const QString& filePathName)
+QPair<int, LuaEditorModelItem*> LuaScriptAdapter::createLuaScript(const QString& filePathName, const QString& content)
 {
     int index = this->findLuaScript(filePathName);
 
@@ -56,16 +116,11 @@ QPair<int, LuaEditorModelItem*> LuaScriptAdapter::createLuaScript(const QString&
     }
 
     LuaScript* luaScript = new LuaScript(filePathName);
-    bool success = luaScript->loadScriptFromFile(filePathName);
-    if (false == success)
-    {
-        return qMakePair(-1, Q_NULLPTR);
-    }
     this->luaScripts.append(luaScript);
 
-    connect(luaScript, &LuaScript::signal_syntaxCheckResult, this, [this, luaScript](bool valid, int line, int start, int end, const QString& message)
+    connect(luaScript, &LuaScript::signal_luaScriptLoaded, this, [this, luaScript](const QString& content)
             {
-                         Q_EMIT signal_syntaxCheckResult(luaScript->getFilePathName(), valid, line, start, end, message);
+                Q_EMIT signal_luaScriptReady(luaScript->getFilePathName(), content);
             });
 
     connect(luaScript, &LuaScript::signal_runtimeError, this, [this, luaScript](bool valid, int line, int start, int end, const QString& message)
@@ -73,6 +128,13 @@ QPair<int, LuaEditorModelItem*> LuaScriptAdapter::createLuaScript(const QString&
                 Q_EMIT signal_runtimeError(luaScript->getFilePathName(), valid, line, start, end, message);
             });
 
+    connect(luaScript, &LuaScript::signal_runtimeErrorRecord, this, [this, luaScript](const LuaRuntimeError& runtimeError)
+            {
+                Q_EMIT signal_runtimeErrorRecord(luaScript->getFilePathName(), runtimeError);
+            });
+
+    luaScript->setLoadedContent(content);
+
     LuaEditorModelItem* luaEditorModelItem = new LuaEditorModelItem(this);
 
     luaEditorModelItem->setFilePathName(filePathName);
@@ -123,6 +185,9 @@ bool LuaScriptAdapter::removeLuaScript(const QString& filePathName)
     // Clean up connections to the LuaScript and stop the thread
     disconnect(luaScript, Q_NULLPTR, this, Q_NULLPTR);
 
+    // A check of the closed script is of no interest anymore
+    this->syntaxCheckService->cancel(luaScript->getFilePathName());
+
     // Now that the LuaScript has been cleaned up, remove it from the QHash
     this->luaScripts.takeAt(index);
 
@@ -152,14 +217,10 @@ bool LuaScriptAdapter::saveLuaScript(const QString& filePathName, const QString&
         return false;
     }
 
-    bool success = luaScript->saveLuaScript(content);
-
-    if (true == success)
-    {
-        Q_EMIT signal_luaScriptSaved();
-    }
+    // Written atomically on a pool thread, repeated saves of the same file are coalesced
+    this->saveService->requestSave(luaScript->getFilePathName(), content);
 
-    return success;
+    return true;
 }
 
 void LuaScriptAdapter::checkSyntax(const QString& filePathName, const QString& luaCode)
@@ -168,36 +229,93 @@ void LuaScriptAdapter::checkSyntax(const QString& filePathName, const QString& l
     if (-1 != index)
     {
         LuaScript* luaScript = this->luaScripts.at(index);
-        luaScript->checkSyntax(luaCode);
+        // Runtime errors are mapped to the latest text
+        luaScript->setContent(luaCode);
+        // Checked in the background, the result is relayed via signal_syntaxCheckResult, if it is still current by then
+        this->syntaxCheckService->requestCheck(luaScript->getFilePathName(), luaCode);
     }
 }
 
-bool LuaScriptAdapter::sendLuaScriptRuntimeError(const QString& filePathName, const QString& errorMessage, int line, int start, int end)
+bool LuaScriptAdapter::sendLuaScriptRuntimeError(const QString& filePathName, const QString& errorMessage, int line, int start, int end, qint64 timestamp)
 {
     int index = this->findLuaScript(filePathName);
     if (-1 != index)
     {
         LuaScript* luaScript = this->luaScripts.at(index);
-        luaScript->checkRuntimeError(errorMessage, line, start, end);
+        luaScript->checkRuntimeError(errorMessage, line, start, end, timestamp);
         return true;
     }
     return false;
 }
 
+void LuaScriptAdapter::compileProject(const QString& folderPath)
+{
+    QSettings settings("NOWA", "NOWALuaScript");
+    const bool stripDebugInfo = settings.value("StripDebugInfo", false).toBool();
+
+    // The files are compiled in parallel, this task only waits for them, so that the gui is not blocked
+    this->compilePool.start([this, folderPath, stripDebugInfo]
+        {
+            QElapsedTimer timer;
+            timer.start();
+
+            const QList<LuaBytecodeCompiler::Result> results = LuaBytecodeCompiler::compileFolder(folderPath, stripDebugInfo, [this](const LuaBytecodeCompiler::Result& result)
+                {
+                    Q_EMIT signal_bytecodeCompileResult(result.filePathName, result.success, result.sourceSize, result.bytecodeSize, result.compileTimeMs, result.message);
+                });
+
+            int failedCount = 0;
+            qint64 sourceSize = 0;
+            qint64 bytecodeSize = 0;
+
+            for (const LuaBytecodeCompiler::Result& result : results)
+            {
+                if (false == result.success)
+                {
+                    ++failedCount;
+                }
+                sourceSize += result.sourceSize;
+                bytecodeSize += result.bytecodeSize;
+            }
+
+            qDebug() << "Compiled" << results.size() << "lua scripts in" << folderPath << "within" << timer.elapsed() << "ms," << failedCount << "failed";
+
+            Q_EMIT signal_compileProjectFinished(results.size(), failedCount, sourceSize, bytecodeSize, timer.nsecsElapsed() / 1000000.0);
+        });
+}
+
 QMap<QString, LuaScriptAdapter::ClassData> LuaScriptAdapter::prepareLuaApi(const QString& filePathName, bool parseSilent)
 {
     QMap<QString, ClassData> apiData;
+    QString message;
 
-    QFile file(filePathName);
-
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    if (false == parseLuaApi(filePathName, apiData, message))
     {
-        QString message = "Unable to open file: " + filePathName;
         qWarning() << message;
         Q_EMIT signal_luaApiPrepareResult(false, false, message);
         return apiData;
     }
 
+    // Save the file path in QSettings for future use
+    QSettings settings("NOWA", "NOWALuaScript");
+    settings.setValue("LuaApiFilePath", filePathName);
+
+    qDebug() << message;
+    Q_EMIT signal_luaApiPrepareResult(parseSilent, true, message);
+
+    return apiData;
+}
+
+bool LuaScriptAdapter::parseLuaApi(const QString& filePathName, QMap<QString, ClassData>& apiData, QString& message)
+{
+    QFile file(filePathName);
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        message = "Unable to open file: " + filePathName;
+        return false;
+    }
+
     QTextStream in(&file);
     QString currentClass;    // Class name
     ClassData currentClassData; // Current class data being populated
@@ -372,67 +490,43 @@ QMap<QString, LuaScriptAdapter::ClassData> LuaScriptAdapter::prepareLuaApi(const
     file.close();
 
     // Resolve inheritance after parsing
-    QSet<QString> visited;
+    resolveInheritance(apiData);
 
-    for (const QString& className : apiData.keys())
-    {
-        appendInheritedMethods(apiData, className, visited);
-    }
+    message = "Lua Api file: " + filePathName + " parsed successfully.";
 
-    // Save the file path in QSettings for future use
-    QSettings settings("NOWA", "NOWALuaScript");
-    settings.setValue("LuaApiFilePath", filePathName);
-
-    QString message = "Lua Api file: " + filePathName + " parsed successfully.";
-    qDebug() << message;
-    Q_EMIT signal_luaApiPrepareResult(parseSilent, true, message);
-
-    return apiData;
+    return true;
 }
 
 void LuaScriptAdapter::resolveInheritance(QMap<QString, ClassData>& apiData)
 {
-    QSet<QString> visited;
-
-    for (const QString& className : apiData.keys())
-    {
-        this->appendInheritedMethods(apiData, className, visited);
-    }
-}
-
-void LuaScriptAdapter::appendInheritedMethods(QMap<QString, ClassData>& apiData, const QString& className, QSet<QString>& visited)
-{
-    if (!apiData.contains(className))
+    // The inherited methods are not copied into each class, the ApiSnapshot shares them along the inherits chain.
+    // Only the chains are checked here, a cycle is cut, so that they can be followed.
+    for (auto it = apiData.begin(); it != apiData.end(); ++it)
     {
-        qWarning() << "Class" << className << "not found in the API data!";
-        return;
-    }
-
-    if (visited.contains(className))
-    {
-        qWarning() << "Cyclic inheritance detected for class" << className;
-        return;
-    }
-
-    visited.insert(className);
-
-    ClassData& classData = apiData[className];
+        QSet<QString> visited;
+        visited.insert(it.key());
 
-    if (!classData.inherits.isEmpty() && apiData.contains(classData.inherits))
-    {
-        appendInheritedMethods(apiData, classData.inherits, visited);
+        ClassData* classData = &it.value();
 
-        const ClassData& parentClassData = apiData[classData.inherits];
-        for (auto it = parentClassData.methods.constBegin(); it != parentClassData.methods.constEnd(); ++it)
+        while (false == classData->inherits.isEmpty())
         {
-            if (!classData.methods.contains(it.key()))
+            auto parentIt = apiData.find(classData->inherits);
+            if (apiData.end() == parentIt)
+            {
+                break;
+            }
+
+            if (true == visited.contains(parentIt.key()))
             {
-                classData.methods[it.key()] = it.value();
+                qWarning() << "Cyclic inheritance detected for class" << parentIt.key();
+                classData->inherits.clear();
+                break;
             }
+
+            visited.insert(parentIt.key());
+            classData = &parentIt.value();
         }
     }
-
-    visited.remove(className);
 }
 
 QStringList LuaScriptAdapter::splitPathTail(const QString& path, int segmentCount)
@@ -5,8 +5,11 @@
 #include <QList>
 #include <QMap>
 #include <QVariant>
+#include <QThreadPool>
 
 #include "backend/luascript.h"
+#include "backend/syntaxcheckservice.h"
+#include "backend/saveservice.h"
 #include "model/luaeditormodelitem.h"
 
 class LuaScriptAdapter : public QObject
@@ -29,24 +32,34 @@ public:
         QString type;
         QString description;
         QString inherits;
-        QMap<QString, MethodData> methods;
+        QMap<QString, MethodData> methods; // Only the ones the class declares, the inherited ones are shared by the ApiSnapshot
     };
 public:
     explicit LuaScriptAdapter(QObject* parent = Q_NULLPTR);
 
     virtual ~LuaScriptAdapter();
 
-    QPair<int, LuaEditorModelItem*> createLuaScript(const QString& filePathName);
+    // Creates the lua script with its content, which has already been loaded by the LuaScriptLoader
+    QPair<int, LuaEditorModelItem*> createLuaScript(const QString& filePathName, const QString& content);
+
+    int findLuaScript(const QString& filePathName);
 
     bool removeLuaScript(const QString& filePathName);
 
+    // Queues the save, false only if there is no such script. Whether the file could be written, is told later by signal_luaScriptSaved
+    // or signal_luaScriptSaveFailed.
     bool saveLuaScript(const QString& filePathName, const QString& content);
 
+    // Parses the lua api file of NOWA-Engine, each class with the methods it declares itself and its parent class. Has no side effects, so that it can be used without gui as well.
+    static bool parseLuaApi(const QString& filePathName, QMap<QString, ClassData>& apiData, QString& message);
+
 public Q_SLOTS:
 
     void checkSyntax(const QString& filePathName, const QString& luaCode);
 
-    bool sendLuaScriptRuntimeError(const QString& filePathName, const QString&  errorMessage, int line, int start, int end);
+    bool sendLuaScriptRuntimeError(const QString& filePathName, const QString&  errorMessage, int line, int start, int end, qint64 timestamp = 0);
+
+    void compileProject(const QString& folderPath);
 
     QMap<QString, ClassData> prepareLuaApi(const QString& filePathName, bool parseSilent);
 
@@ -55,20 +68,24 @@ Q_SIGNALS:
     void signal_luaScriptReady(const QString& filePathName, const QString& content);
     void signal_syntaxCheckResult(const QString& filePathName, bool valid, int line, int start, int end, const QString& message);
     void signal_runtimeError(const QString& filePathName, bool valid, int line, int start, int end, const QString& message);
-    void signal_luaScriptSaved();
+    void signal_runtimeErrorRecord(const QString& filePathName, const LuaRuntimeError& runtimeError);
+    void signal_luaScriptSaved(const QString& filePathName, const QString& content);
+    void signal_luaScriptSaveFailed(const QString& filePathName, const QString& message);
     void signal_luaApiPrepareResult(bool silent, bool success, const QString& message);
+    void signal_bytecodeCompileResult(const QString& filePathName, bool success, qint64 sourceSize, qint64 bytecodeSize, double compileTimeMs, const QString& message);
+    void signal_compileProjectFinished(int fileCount, int failedCount, qint64 sourceSize, qint64 bytecodeSize, double elapsedMs);
 
 private:
     QStringList splitPathTail(const QString& path, int segmentCount = 2);
 
-    int findLuaScript(const QString& filePathName);
-
-    void resolveInheritance(QMap<QString, ClassData>& apiData);
-
-    void appendInheritedMethods(QMap<QString, ClassData>& apiData, const QString& className, QSet<QString>& visited);
+    static void resolveInheritance(QMap<QString, ClassData>& apiData);
 private:
     QList<LuaScript*> luaScripts;
     bool luaApiCreatedIntially;
+    SyntaxCheckService* syntaxCheckService;
+    SaveService* saveService;
+    // Compile on save and compile project, their tasks emit on the adapter, so it waits for them, before it goes away
+    QThreadPool compilePool;
 };
 
 #endif // LUASCRIPTADAPTER_H
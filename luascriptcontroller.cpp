@@ -4,8 +4,11 @@
 #include "model/luaeditormodelitem.h"
 #include "model/apimodel.h"
 
+#include <QtConcurrent>
 #include <QDebug>
 
+#include <algorithm>
+
 LuaScriptController::LuaScriptController(QQmlApplicationEngine* qmlEngine, QSharedPointer<LuaScriptAdapter> ptrLuaScriptAdapter, QObject* parent)
     : QObject{parent},
       qmlEngine(qmlEngine),
@@ -13,12 +16,17 @@ LuaScriptController::LuaScriptController(QQmlApplicationEngine* qmlEngine, QShar
       luaScriptQmlAdapter(LuaScriptQmlAdapter::instance()),
       luaEditorModel(LuaEditorModel::instance()),
       luaScriptQmlComponent(Q_NULLPTR),
-      luaEditorContainer(Q_NULLPTR)
+      luaEditorContainer(Q_NULLPTR),
+      runtimeErrorCoalescer(Q_NULLPTR)
 {
+    this->runtimeErrorCoalescer = new RuntimeErrorCoalescer(250, this);
+    connect(this->runtimeErrorCoalescer, &RuntimeErrorCoalescer::signal_runtimeErrorCoalesced, this, &LuaScriptController::deliverLuaScriptError);
+
     connect(luaEditorModel, &LuaEditorModel::signal_requestAddLuaScript, this, &LuaScriptController::slot_createLuaScript);
     connect(luaEditorModel, &LuaEditorModel::signal_requestRemoveLuaScript, this, &LuaScriptController::slot_removeLuaScript);
     connect(luaEditorModel, &LuaEditorModel::signal_requestSaveLuaScript, this, &LuaScriptController::slot_saveLuaScript);
     connect(ptrLuaScriptAdapter.data(), &LuaScriptAdapter::signal_luaScriptSaved, this, &LuaScriptController::slot_luaScriptSaved);
+    connect(ptrLuaScriptAdapter.data(), &LuaScriptAdapter::signal_luaScriptSaveFailed, this->luaScriptQmlAdapter, &LuaScriptQmlAdapter::luaScriptSaveFailed);
 
     connect(this->luaScriptQmlAdapter, &LuaScriptQmlAdapter::signal_requestSyntaxCheck, ptrLuaScriptAdapter.data(), &LuaScriptAdapter::checkSyntax);
 
@@ -30,9 +38,15 @@ LuaScriptController::LuaScriptController(QQmlApplicationEngine* qmlEngine, QShar
 
     connect(ptrLuaScriptAdapter.data(), &LuaScriptAdapter::signal_syntaxCheckResult, this->luaScriptQmlAdapter, &LuaScriptQmlAdapter::syntaxCheckResult);
     connect(ptrLuaScriptAdapter.data(), &LuaScriptAdapter::signal_runtimeError, this->luaScriptQmlAdapter, &LuaScriptQmlAdapter::signal_runtimeErrorResult);
+    connect(ptrLuaScriptAdapter.data(), &LuaScriptAdapter::signal_runtimeErrorRecord, this->luaScriptQmlAdapter, &LuaScriptQmlAdapter::runtimeErrorRecordResult);
 
     connect(ptrLuaScriptAdapter.data(), &LuaScriptAdapter::signal_luaApiPrepareResult, this->luaScriptQmlAdapter, &LuaScriptQmlAdapter::luaApiPreparationResult);
 
+    // Compile results come from pool threads, they are queued to the gui thread
+    connect(this->luaScriptQmlAdapter, &LuaScriptQmlAdapter::signal_requestCompileProject, ptrLuaScriptAdapter.data(), &LuaScriptAdapter::compileProject);
+    connect(ptrLuaScriptAdapter.data(), &LuaScriptAdapter::signal_bytecodeCompileResult, this->luaScriptQmlAdapter, &LuaScriptQmlAdapter::bytecodeCompileResult, Qt::QueuedConnection);
+    connect(ptrLuaScriptAdapter.data(), &LuaScriptAdapter::signal_compileProjectFinished, this->luaScriptQmlAdapter, &LuaScriptQmlAdapter::compileProjectFinished, Qt::QueuedConnection);
+
 }
 
 LuaScriptController::~LuaScriptController()
@@ -56,8 +70,69 @@ void LuaScriptController::slot_createLuaScript(const QString& filePathName)
 
     tempFilePathName = tempFilePathName.replace("\\", "/");
 
+    const int index = this->ptrLuaScriptAdapter->findLuaScript(tempFilePathName);
+    if (index >= 0)
+    {
+        // There is already this lua script, so send event with index to set current tab.
+        this->luaScriptQmlAdapter->changeTab(index);
+        return;
+    }
+
+    // Already being loaded, e.g. NOWA-Design sent the same path several times in a row
+    if (true == this->loadOrder.contains(tempFilePathName))
+    {
+        return;
+    }
+
+    // Reading and decoding runs on a worker thread, so that many scripts opened in a row do not stall the ui. The tab is opened, when the content is there.
+    // Its place among the tabs is taken now, a small file does not overtake a large one requested before it, e.g. when a session is restored.
+    this->loadOrder.append(tempFilePathName);
+
+    QFutureWatcher<LuaScriptLoader::Result>* loadWatcher = new QFutureWatcher<LuaScriptLoader::Result>(this);
+
+    connect(loadWatcher, &QFutureWatcher<LuaScriptLoader::Result>::finished, this, [this, loadWatcher, tempFilePathName]()
+            {
+                loadWatcher->deleteLater();
+
+                this->loadResults.insert(tempFilePathName, loadWatcher->result());
+                this->openLoadedLuaScripts();
+            });
+
+    loadWatcher->setFuture(QtConcurrent::run(&LuaScriptLoader::load, tempFilePathName));
+}
+
+void LuaScriptController::openLoadedLuaScripts(void)
+{
+    // A script, which is still being loaded, holds back the ones requested after it
+    while (false == this->loadOrder.isEmpty() && true == this->loadResults.contains(this->loadOrder.first()))
+    {
+        const QString filePathName = this->loadOrder.takeFirst();
+        const LuaScriptLoader::Result result = this->loadResults.take(filePathName);
+        const QList<RuntimeErrorCoalescer::Entry> errorEntries = this->pendingErrors.take(filePathName);
+
+        if (false == result.success)
+        {
+            qWarning() << result.message;
+            continue;
+        }
+
+        this->openLuaScript(filePathName, result.content);
+
+        for (const RuntimeErrorCoalescer::Entry& entry : errorEntries)
+        {
+            if (true == this->ptrLuaScriptAdapter->sendLuaScriptRuntimeError(entry.filePathName, entry.errorMessage, entry.line, entry.start, entry.end, entry.lastTimestamp))
+            {
+                this->luaScriptQmlAdapter->runtimeErrorHitsResult(entry.filePathName, entry.line, entry.errorMessage, static_cast<qint64>(entry.hitCount),
+                                                                  entry.firstTimestamp, entry.lastTimestamp);
+            }
+        }
+    }
+}
+
+void LuaScriptController::openLuaScript(const QString& filePathName, const QString& content)
+{
     // Try creating a node model and associate it with backendmodel, let it be filled and configured
-    QPair<int, LuaEditorModelItem*> resultData = this->ptrLuaScriptAdapter->createLuaScript(tempFilePathName);
+    QPair<int, LuaEditorModelItem*> resultData = this->ptrLuaScriptAdapter->createLuaScript(filePathName, content);
 
     LuaEditorModelItem* luaEditorModelItem = resultData.second;
 
@@ -126,6 +201,9 @@ void LuaScriptController::slot_removeLuaScript(int index)
         return;
     }
 
+    // If the script is opened again, its errors count as new
+    this->runtimeErrorCoalescer->clear(luaEditorModelItem->getFilePathName());
+
     luaEditorQml->deleteLater();
 
     this->luaEditorQmls.removeOne(luaEditorQml);
@@ -143,19 +221,52 @@ void LuaScriptController::slot_saveLuaScript(const QString& filePathName, const
     }
 }
 
-void LuaScriptController::slot_luaScriptSaved()
+void LuaScriptController::slot_luaScriptSaved(const QString& filePathName, const QString& content)
+{
+    this->luaEditorModel->luaScriptSaved(filePathName, content);
+}
+
+void LuaScriptController::slot_sendLuaScriptError(const QString& filePathName, const QString& errorMessage, int line, int start, int end, int hitCount)
 {
-    this->luaEditorModel->luaScriptSaved();
+    this->runtimeErrorCoalescer->report(filePathName, errorMessage, line, start, end, hitCount);
 }
 
-void LuaScriptController::slot_sendLuaScriptError(const QString& filePathName, const QString& errorMessage, int line, int start, int end)
+void LuaScriptController::deliverLuaScriptError(const RuntimeErrorCoalescer::Entry& entry)
 {
     // If there is no such lua script so far, create it first and then send the error
-    bool success = this->ptrLuaScriptAdapter->sendLuaScriptRuntimeError(filePathName, errorMessage, line, start, end);
-    if (false == success)
+    bool success = this->ptrLuaScriptAdapter->sendLuaScriptRuntimeError(entry.filePathName, entry.errorMessage, entry.line, entry.start, entry.end, entry.lastTimestamp);
+    if (true == success)
     {
-        this->slot_createLuaScript(filePathName);
-        this->ptrLuaScriptAdapter->sendLuaScriptRuntimeError(filePathName, errorMessage, line, start, end);
+        this->luaScriptQmlAdapter->runtimeErrorHitsResult(entry.filePathName, entry.line, entry.errorMessage, static_cast<qint64>(entry.hitCount),
+                                                          entry.firstTimestamp, entry.lastTimestamp);
+    }
+    else
+    {
+        this->slot_createLuaScript(entry.filePathName);
+
+        // The script is loaded asynchronously, the error is sent, once it has been opened
+        QString tempFilePathName = entry.filePathName;
+        tempFilePathName = tempFilePathName.replace("\\", "/");
+
+        if (true == this->loadOrder.contains(tempFilePathName))
+        {
+            // Each flush of the coalescer brings the same error again with a higher count, only the latest one is kept, so that it is delivered once
+            QList<RuntimeErrorCoalescer::Entry>& errorEntries = this->pendingErrors[tempFilePathName];
+
+            auto it = std::find_if(errorEntries.begin(), errorEntries.end(), [&entry](const RuntimeErrorCoalescer::Entry& pendingEntry)
+                                   {
+                                       return pendingEntry.line == entry.line && pendingEntry.errorMessage == entry.errorMessage;
+                                   });
+
+            if (errorEntries.end() != it)
+            {
+                *it = entry;
+            }
+            else
+            {
+                errorEntries.append(entry);
+            }
+        }
     }
 }
 
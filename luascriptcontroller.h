@@ -8,10 +8,14 @@
 #include <QQmlApplicationEngine>
 #include <QQuickItem>
 #include <QList>
+#include <QHash>
+#include <QFutureWatcher>
 
 #include "luascriptqmladapter.h"
 #include "model/luaeditormodel.h"
 #include "qml/luaeditorqml.h"
+#include "backend/luascriptloader.h"
+#include "backend/runtimeerrorcoalescer.h"
 
 class LuaScriptAdapter;
 class LuaEditorModelItem;
@@ -30,12 +34,22 @@ public slots:
 
     void slot_saveLuaScript(const QString& filePathName, const QString& content);
 
-    void slot_luaScriptSaved();
+    void slot_luaScriptSaved(const QString& filePathName, const QString& content);
 
-    void slot_sendLuaScriptError(const QString& filePathName, const QString& errorMessage, int line, int start, int end);
+    // Equal errors are coalesced, see RuntimeErrorCoalescer. hitCount is how often the sender has already seen the error in a row.
+    void slot_sendLuaScriptError(const QString& filePathName, const QString& errorMessage, int line, int start, int end, int hitCount = 1);
 
     void prepareLuaApi(const QString& filePathName, bool parseSilent);
 private:
+    // Creates the editor and the tab for the loaded content
+    void openLuaScript(const QString& filePathName, const QString& content);
+
+    // Opens the loaded scripts in the order, in which they have been requested
+    void openLoadedLuaScripts(void);
+
+    // Highlights the coalesced error in its script, which is opened first, if necessary
+    void deliverLuaScriptError(const RuntimeErrorCoalescer::Entry& entry);
+
     LuaEditorQml* createNewLuaEditorQml(void);
 
     // Function to recursively search for a child item by name
@@ -50,6 +64,15 @@ private:
     QQuickItem* luaEditorContainer;
 
     QList<LuaEditorQml*> luaEditorQmls;
+
+    // Scripts, which are being loaded on a worker thread or wait for the ones requested before them, in the order of the requests.
+    // So the same path is not loaded twice, if it is requested again meanwhile.
+    QList<QString> loadOrder;
+    QHash<QString, LuaScriptLoader::Result> loadResults;
+    // Runtime errors of scripts, which are not opened yet, the latest entry per line and message
+    QHash<QString, QList<RuntimeErrorCoalescer::Entry>> pendingErrors;
+
+    RuntimeErrorCoalescer* runtimeErrorCoalescer;
 };
 
 #endif // LUASCRIPTCONTROLLER_H
@@ -1,12 +1,18 @@
 #include "luascriptqmladapter.h"
 
+#include <QSettings>
+
 LuaScriptQmlAdapter* LuaScriptQmlAdapter::ms_pInstance = Q_NULLPTR;
 QMutex LuaScriptQmlAdapter::ms_mutex;
 
 LuaScriptQmlAdapter::LuaScriptQmlAdapter(QObject* parent)
-    : QObject{parent}
+    : QObject{parent},
+    compileOnSave(false),
+    stripDebugInfo(false)
 {
-
+    QSettings settings("NOWA", "NOWALuaScript");
+    this->compileOnSave = settings.value("CompileOnSave", false).toBool();
+    this->stripDebugInfo = settings.value("StripDebugInfo", false).toBool();
 }
 
 LuaScriptQmlAdapter* LuaScriptQmlAdapter::instance()
@@ -43,6 +49,50 @@ void LuaScriptQmlAdapter::relayKeyPress(int key)
     Q_EMIT signal_relayKeyPress(key);
 }
 
+void LuaScriptQmlAdapter::compileProject(const QString& folderPath)
+{
+    Q_EMIT signal_requestCompileProject(folderPath);
+}
+
+bool LuaScriptQmlAdapter::getCompileOnSave(void) const
+{
+    return this->compileOnSave;
+}
+
+void LuaScriptQmlAdapter::setCompileOnSave(bool compileOnSave)
+{
+    if (this->compileOnSave == compileOnSave)
+    {
+        return;
+    }
+
+    // The backend reads the settings, when a script is saved
+    this->compileOnSave = compileOnSave;
+    QSettings settings("NOWA", "NOWALuaScript");
+    settings.setValue("CompileOnSave", compileOnSave);
+
+    Q_EMIT compileOnSaveChanged();
+}
+
+bool LuaScriptQmlAdapter::getStripDebugInfo(void) const
+{
+    return this->stripDebugInfo;
+}
+
+void LuaScriptQmlAdapter::setStripDebugInfo(bool stripDebugInfo)
+{
+    if (this->stripDebugInfo == stripDebugInfo)
+    {
+        return;
+    }
+
+    this->stripDebugInfo = stripDebugInfo;
+    QSettings settings("NOWA", "NOWALuaScript");
+    settings.setValue("StripDebugInfo", stripDebugInfo);
+
+    Q_EMIT stripDebugInfoChanged();
+}
+
 void LuaScriptQmlAdapter::checkSyntax(const QString& filePathName, const QString& luaCode)
 {
     Q_EMIT signal_requestSyntaxCheck(filePathName, luaCode);
@@ -58,6 +108,16 @@ void LuaScriptQmlAdapter::runtimeErrorResult(const QString& filePathName, bool v
     Q_EMIT signal_runtimeErrorResult(filePathName, valid, line, start, end, message);
 }
 
+void LuaScriptQmlAdapter::runtimeErrorRecordResult(const QString& filePathName, const LuaRuntimeError& runtimeError)
+{
+    Q_EMIT signal_runtimeErrorRecordResult(filePathName, runtimeError.toVariantMap());
+}
+
+void LuaScriptQmlAdapter::runtimeErrorHitsResult(const QString& filePathName, int line, const QString& message, qint64 hitCount, qint64 firstTimestamp, qint64 lastTimestamp)
+{
+    Q_EMIT signal_runtimeErrorHitsResult(filePathName, line, message, hitCount, firstTimestamp, lastTimestamp);
+}
+
 void LuaScriptQmlAdapter::luaApiPreparationResult(bool parseSilent, bool success, const QString& message)
 {
     Q_EMIT signal_luaApiPreparationResult(parseSilent, success, message);
@@ -67,3 +127,18 @@ void LuaScriptQmlAdapter::resultSearchMatchCount(int matchCount)
 {
     Q_EMIT signal_resultSearchMatchCount(matchCount);
 }
+
+void LuaScriptQmlAdapter::bytecodeCompileResult(const QString& filePathName, bool success, qint64 sourceSize, qint64 bytecodeSize, double compileTimeMs, const QString& message)
+{
+    Q_EMIT signal_bytecodeCompileResult(filePathName, success, sourceSize, bytecodeSize, compileTimeMs, message);
+}
+
+void LuaScriptQmlAdapter::compileProjectFinished(int fileCount, int failedCount, qint64 sourceSize, qint64 bytecodeSize, double elapsedMs)
+{
+    Q_EMIT signal_compileProjectFinished(fileCount, failedCount, sourceSize, bytecodeSize, elapsedMs);
+}
+
+void LuaScriptQmlAdapter::luaScriptSaveFailed(const QString& filePathName, const QString& message)
+{
+    Q_EMIT signal_luaScriptSaveFailed(filePathName, message);
+}
@@ -6,9 +6,15 @@
 #include <QQuickItem>
 #include <QMutex>
 
+#include "backend/luaruntimeerror.h"
+
 class LuaScriptQmlAdapter : public QObject
 {
     Q_OBJECT
+public:
+    Q_PROPERTY(bool compileOnSave READ getCompileOnSave WRITE setCompileOnSave NOTIFY compileOnSaveChanged FINAL)
+
+    Q_PROPERTY(bool stripDebugInfo READ getStripDebugInfo WRITE setStripDebugInfo NOTIFY stripDebugInfoChanged FINAL)
 public:
     explicit LuaScriptQmlAdapter(QObject* parent = Q_NULLPTR);
 
@@ -19,6 +25,16 @@ public:
     Q_INVOKABLE void requestSetLuaApi(const QString& filePathName, bool parseSilent);
 
     Q_INVOKABLE void relayKeyPress(int key);
+
+    Q_INVOKABLE void compileProject(const QString& folderPath);
+
+    bool getCompileOnSave(void) const;
+
+    void setCompileOnSave(bool compileOnSave);
+
+    bool getStripDebugInfo(void) const;
+
+    void setStripDebugInfo(bool stripDebugInfo);
 public:
     /**
      * @brief instance is the getter used to receive the object of this singleton implementation.
@@ -37,22 +53,45 @@ Q_SIGNALS:
     void signal_requestSyntaxCheck(const QString& filePathName, const QString& luaCode);
     void signal_syntaxCheckResult(const QString& filePathName, bool valid, int line, int start, int end, const QString& message);
     void signal_runtimeErrorResult(const QString& filePathName, bool valid, int line, int start, int end, const QString& message);
+    // Message, timestamp and the frames of the traceback, each with source, line, functionName, inDocument, start and end
+    void signal_runtimeErrorRecordResult(const QString& filePathName, const QVariantMap& runtimeError);
+    // How often the game has reported the error so far, timestamps in ms since epoch
+    void signal_runtimeErrorHitsResult(const QString& filePathName, int line, const QString& message, qint64 hitCount, qint64 firstTimestamp, qint64 lastTimestamp);
     void signal_changeTab(int newTabIndex);
     void signal_requestSetLuaApi(const QString& filePathName, bool parseSilent);
     void signal_luaApiPreparationResult(bool parseSilent, bool success, const QString& message);
     void signal_relayKeyPress(int key);
     void signal_resultSearchMatchCount(int matchCount);
+    void signal_requestCompileProject(const QString& folderPath);
+    void signal_bytecodeCompileResult(const QString& filePathName, bool success, qint64 sourceSize, qint64 bytecodeSize, double compileTimeMs, const QString& message);
+    void signal_compileProjectFinished(int fileCount, int failedCount, qint64 sourceSize, qint64 bytecodeSize, double elapsedMs);
+    void signal_luaScriptSaveFailed(const QString& filePathName, const QString& message);
+    void compileOnSaveChanged();
+    void stripDebugInfoChanged();
 public Q_SLOTS:
     void syntaxCheckResult(const QString& filePathName, bool valid, int line, int start, int end, const QString& message);
 
     void runtimeErrorResult(const QString& filePathName, bool valid, int line, int start, int end, const QString& message);
 
+    void runtimeErrorRecordResult(const QString& filePathName, const LuaRuntimeError& runtimeError);
+
+    void runtimeErrorHitsResult(const QString& filePathName, int line, const QString& message, qint64 hitCount, qint64 firstTimestamp, qint64 lastTimestamp);
+
     void luaApiPreparationResult(bool parseSilent, bool success, const QString& message);
 
     void resultSearchMatchCount(int matchCount);
+
+    void bytecodeCompileResult(const QString& filePathName, bool success, qint64 sourceSize, qint64 bytecodeSize, double compileTimeMs, const QString& message);
+
+    void compileProjectFinished(int fileCount, int failedCount, qint64 sourceSize, qint64 bytecodeSize, double elapsedMs);
+
+    void luaScriptSaveFailed(const QString& filePathName, const QString& message);
 private:
     static LuaScriptQmlAdapter* ms_pInstance;
     static QMutex ms_mutex;
+private:
+    bool compileOnSave;
+    bool stripDebugInfo;
 };
 
 #endif // LUASCRIPTQMLADAPTER_H
@@ -9,7 +9,9 @@
 #include "appcommunicator.h"
 #include "model/luaeditormodel.h"
 #include "model/apimodel.h"
+#include "model/symbolsearchmodel.h"
 #include "qml/luaeditorqml.h"
+#include "backend/luacheckcommand.h"
 
 #include <QQuickWindow>
 #include <QDebug>
@@ -44,6 +46,18 @@ void activateWindow(const QQmlApplicationEngine& engine)
 
 int main(int argc, char *argv[])
 {
+    // Headless check of a whole folder, e.g. in a build pipeline, no gui is created at all
+    if (true == LuaCheckCommand::isRequested(argc, argv))
+    {
+        QCoreApplication coreApp(argc, argv);
+        coreApp.setOrganizationName("NOWA");
+        coreApp.setOrganizationDomain("https://lukas-kalinowski.com");
+        coreApp.setApplicationName("NOWALuaScript");
+
+        LuaCheckCommand luaCheckCommand;
+        return luaCheckCommand.run(coreApp.arguments());
+    }
+
     QGuiApplication app(argc, argv);
     app.setOrganizationName("NOWA");
     app.setOrganizationDomain("https://lukas-kalinowski.com");
@@ -60,6 +74,22 @@ int main(int argc, char *argv[])
     app.setWindowIcon(QIcon(":/icons/NOWALuaScript.icns")); // macOS
 #endif
 
+    QStringList initialLuaScriptPaths;
+    // Handle initial Lua script paths from command-line arguments
+    for (int i = 1; i < argc; ++i)
+    {
+        initialLuaScriptPaths.append(QString::fromLocal8Bit(argv[i]));
+        qDebug() << "Opening Lua script at:" << initialLuaScriptPaths.last();
+    }
+
+#ifdef QT_NO_DEBUG
+    // Another instance opens the scripts and raises its window, this one is not needed, no qml is loaded for it
+    if (true == AppCommunicator::sendFilesToRunningInstance(initialLuaScriptPaths))
+    {
+        return 0;
+    }
+#endif
+
     QQmlApplicationEngine engine;
     // For custom modules
     engine.addImportPath(QStringLiteral("qrc:/qml_files"));
@@ -67,19 +97,12 @@ int main(int argc, char *argv[])
     qmlRegisterSingletonType<LuaScriptQmlAdapter>("NOWALuaScript", 1, 0, "LuaScriptQmlAdapter", LuaScriptQmlAdapter::getSingletonTypeProvider);
     qmlRegisterSingletonType<LuaEditorModel>("NOWALuaScript", 1, 0, "NOWALuaEditorModel", LuaEditorModel::getSingletonTypeProvider);
     qmlRegisterUncreatableType<LuaEditorModelItem>("NOWALuaScript", 1, 0, "LuaScriptModelItem", "Not ment to be created in qml.");
+    qmlRegisterUncreatableType<CompletionListModel>("NOWALuaScript", 1, 0, "CompletionListModel", "Owned by NOWAApiModel.");
     qmlRegisterSingletonType<ApiModel>("NOWALuaScript", 1, 0, "NOWAApiModel", ApiModel::getSingletonTypeProvider);
+    qmlRegisterSingletonType<SymbolSearchModel>("NOWALuaScript", 1, 0, "NOWASymbolSearchModel", SymbolSearchModel::getSingletonTypeProvider);
     // Register LuaEditorQml as a QML type
     qmlRegisterType<LuaEditorQml>("NOWALuaScript", 1, 0, "LuaEditorQml");
 
-    QString initialLuaScriptPath;
-    // Handle initial Lua script path from command-line arguments
-    if (argc > 1)
-    {
-        initialLuaScriptPath = argv[1]; // First argument is the Lua script file path
-        qDebug() << "Opening Lua script at:" << initialLuaScriptPath;
-        // Handle the initial Lua script (open in editor)
-    }
-
     QSharedPointer<LuaScriptAdapter> ptrLuaScriptAdapter(new LuaScriptAdapter());
     QSharedPointer<LuaScriptController> ptrLuaScriptController(new LuaScriptController(&engine, ptrLuaScriptAdapter, &app));
 
@@ -89,28 +112,18 @@ int main(int argc, char *argv[])
     Qt::QueuedConnection);
     engine.load(url);
 
-#ifdef QT_NO_DEBUG
-    if (true == AppCommunicator::isInstanceRunning())
-    {
-        if (false == initialLuaScriptPath.isEmpty())
-        {
-            activateWindow(engine);
-
-            AppCommunicator::sendFileToRunningInstance(initialLuaScriptPath);
-        }
-        return 0;
-    }
-#endif
-
     QSharedPointer<AppCommunicator> ptrAppCommunicator(new AppCommunicator(ptrLuaScriptController));
 
     QObject::connect(ptrAppCommunicator.get(), &AppCommunicator::fileReceived,
-                     [=, &engine](const QString& filePath)
+                     [=](const QString& filePath)
                      {
                         ptrLuaScriptController.get()->slot_createLuaScript(filePath);
+                     });
 
+    QObject::connect(ptrAppCommunicator.get(), &AppCommunicator::activationRequested,
+                     [&engine]()
+                     {
                         activateWindow(engine);
-
                      });
 
     // Delete any existing communication file at start
@@ -124,8 +137,8 @@ int main(int argc, char *argv[])
 
 
 
-    // After QML is ready, set a potential first lua script and load it, if it comes from the args
-    if (false == initialLuaScriptPath.isEmpty())
+    // After QML is ready, set the potential lua scripts and load them, if they come from the args
+    for (const QString& initialLuaScriptPath : initialLuaScriptPaths)
     {
         ptrLuaScriptController->slot_createLuaScript(initialLuaScriptPath);
     }
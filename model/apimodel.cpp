@@ -1,85 +1,34 @@
 #include "apimodel.h"
 
+#include <QDebug>
+
 ApiModel* ApiModel::ms_pInstance = Q_NULLPTR;
 QMutex ApiModel::ms_mutex;
 
 ApiModel::ApiModel(QObject* parent)
     : QAbstractListModel{parent},
+    snapshot(std::make_shared<const ApiSnapshot>()),
     isIntellisenseShown(false),
     isMatchedFunctionShown(false)
 {
-
+    this->methodsForSelectedClassModel = new CompletionListModel(this);
+    this->constantsForSelectedClassModel = new CompletionListModel(this);
+    this->matchedVariablesModel = new CompletionListModel(this);
 }
 
 QVariantList ApiModel::getMethodsForClassName(const QString& className)
 {
-    QVariantList methods;
-    if (false == this->isValidClassName(className))
-    {
-        return methods;
-    }
-
-    const LuaScriptAdapter::ClassData& classData = this->apiData[className];
-
-    // Loop over methods in the selected class and convert them to QVariantMap
-    for (auto it = classData.methods.begin(); it != classData.methods.end(); ++it)
-    {
-        QVariantMap methodMap;
-        QString methodName = it.key(); // Get the method name from the key of the QMap
-
-        // Value types are constants and no methods
-        if (it.value().type == "value")
-        {
-            continue;
-        }
-
-        // Populate methodMap with the correct access pattern
-        methodMap["name"] = methodName;      // Assuming you want to include the method name
-        methodMap["type"] = it.value().type; // Accessing the MethodData's fields correctly
-        methodMap["description"] = it.value().description;
-        methodMap["args"] = it.value().args;
-        methodMap["returns"] = it.value().returns;
-        methodMap["valuetype"] = it.value().valuetype;
-
-        methods.append(methodMap); // Append method to the list
-    }
-
-    return methods;
+    return this->getSnapshot()->getMethodsForClassName(className);
 }
 
 QVariantList ApiModel::getConstantsForClassName(const QString& className)
 {
-    QVariantList constants;
-    if (false == this->isValidClassName(className))
-    {
-        return constants;
-    }
-
-    const LuaScriptAdapter::ClassData& classData = this->apiData[className];
-
-    // Loop over methods in the selected class and convert them to QVariantMap
-    for (auto it = classData.methods.begin(); it != classData.methods.end(); ++it)
-    {
-        QVariantMap constantMap;
-
-        // Value types are constants and no methods
-        if (it.value().type != "value")
-        {
-            continue;
-        }
-
-        // Populate methodMap with the correct access pattern
-        constantMap["name"] = it.key();      // Assuming you want to include the method name
-
-        constants.append(constantMap); // Append method to the list
-    }
-
-    return constants;
+    return this->getSnapshot()->getConstantsForClassName(className);
 }
 
 bool ApiModel::getHasLuaApi() const
 {
-    return false == this->apiData.isEmpty();
+    return this->getSnapshot()->getClassCount() > 0;
 }
 
 bool ApiModel::getIsIntellisenseShown() const
@@ -108,19 +57,23 @@ bool ApiModel::updateMethodsForSelectedClass()
         return success;
     }
 
-    if (this->apiData.contains(this->selectedClassName))
+    const std::shared_ptr<const ApiSnapshot> apiSnapshot = this->getSnapshot();
+
+    const ClassRecord* classRecord = apiSnapshot->findClass(this->selectedClassName);
+    if (Q_NULLPTR != classRecord)
     {
-        this->setClassType(this->apiData[this->selectedClassName].type);
-        this->setClassDescription(this->apiData[this->selectedClassName].description);
-        this->setClassInherits(this->apiData[this->selectedClassName].inherits);
+        this->setClassType(classRecord->type);
+        this->setClassDescription(classRecord->description);
+        this->setClassInherits(classRecord->inherits);
 
-        this->methodsForSelectedClass = this->getMethodsForClassName(this->selectedClassName);
+        this->methodsForSelectedClass = apiSnapshot->getMethodsForClassName(this->selectedClassName);
 
         success = true;
     }
 
     if (true == success)
     {
+        this->methodsForSelectedClassModel->setEntries(this->methodsForSelectedClass);
         Q_EMIT methodsForSelectedClassChanged();  // Notify QML to refresh the list
     }
 
@@ -137,19 +90,23 @@ bool ApiModel::updateConstantsForSelectedClass()
         return success;
     }
 
-    if (this->apiData.contains(this->selectedClassName))
+    const std::shared_ptr<const ApiSnapshot> apiSnapshot = this->getSnapshot();
+
+    const ClassRecord* classRecord = apiSnapshot->findClass(this->selectedClassName);
+    if (Q_NULLPTR != classRecord)
     {
-        this->setClassType(this->apiData[this->selectedClassName].type);
-        this->setClassDescription(this->apiData[this->selectedClassName].description);
-        this->setClassInherits(this->apiData[this->selectedClassName].inherits);
+        this->setClassType(classRecord->type);
+        this->setClassDescription(classRecord->description);
+        this->setClassInherits(classRecord->inherits);
 
-        this->constantsForSelectedClass = this->getConstantsForClassName(this->selectedClassName);
+        this->constantsForSelectedClass = apiSnapshot->getConstantsForClassName(this->selectedClassName);
 
         success = true;
     }
 
     if (true == success)
     {
+        this->constantsForSelectedClassModel->setEntries(this->constantsForSelectedClass);
         Q_EMIT constantsForSelectedClassChanged();  // Notify QML to refresh the list
     }
 
@@ -225,46 +182,55 @@ QObject* ApiModel::getSingletonTypeProvider(QQmlEngine* pEngine, QJSEngine* pScr
 
 void ApiModel::setApiData(const QMap<QString, LuaScriptAdapter::ClassData>& apiData)
 {
+    // Built before the reset, the worker goes on with the old snapshot meanwhile
+    const std::shared_ptr<const ApiSnapshot> newSnapshot = std::make_shared<const ApiSnapshot>(apiData);
+
     beginResetModel();
-    this->apiData = apiData;
+    {
+        QMutexLocker lock(&this->snapshotMutex);
+        this->snapshot = newSnapshot;
+    }
     endResetModel();
+
+    const MemoryReport memoryReport = newSnapshot->getMemoryReport();
+    qDebug() << "Lua api set, classes:" << memoryReport.classCount << "methods:" << memoryReport.methodCount << "members:" << memoryReport.memberCount << "bytes:" << memoryReport.totalBytes
+             << "strings:" << memoryReport.stringBytes << "containers:" << memoryReport.containerBytes << "member table:" << memoryReport.memberTableBytes
+             << "index:" << memoryReport.indexBytes << "symbol index:" << memoryReport.symbolIndexBytes << "estimated with copied inherited methods:" << memoryReport.estimatedCopiedLayoutBytes;
 }
 
-const QMap<QString, LuaScriptAdapter::ClassData>& ApiModel::getApiData(void) const
+std::shared_ptr<const ApiSnapshot> ApiModel::getSnapshot(void) const
 {
-    return this->apiData;
+    QMutexLocker lock(&this->snapshotMutex);
+    return this->snapshot;
 }
 
 int ApiModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
-    return this->apiData.size();
+    return this->getSnapshot()->getClassCount();
 }
 
 QVariant ApiModel::data(const QModelIndex& index, int role) const
 {
-    if (!index.isValid() || index.row() >= this->apiData.size())
-    {
-        return QVariant();
-    }
+    const std::shared_ptr<const ApiSnapshot> apiSnapshot = this->getSnapshot();
 
-    QString className = this->apiData.keys().at(index.row());
-    if (false == this->apiData.contains(className))
+    if (!index.isValid() || index.row() >= apiSnapshot->getClassCount())
     {
         return QVariant();
     }
-    const LuaScriptAdapter::ClassData& classData = this->apiData[className];
+
+    const ClassRecord& classRecord = apiSnapshot->getClassAt(index.row());
 
     switch (role)
     {
     case ClassNameRole:
-        return className;
+        return classRecord.name;
     case ClassTypeRole:
-        return classData.type;
+        return classRecord.type;
     case ClassDescriptionRole:
-        return classData.description;
+        return classRecord.description;
     case ClassInheritsRole:
-        return classData.inherits;
+        return classRecord.inherits;
     default:
         return QVariant();
     }
@@ -357,104 +323,67 @@ QVariantList ApiModel::getMatchedVariables() const
     return this->matchedVariables;
 }
 
-void ApiModel::processMatchedMethodsForSelectedClass(const QString& selectedClassName, const QString& typedAfterColon)
+CompletionListModel* ApiModel::getMethodsForSelectedClassModel() const
 {
-    this->methodsForSelectedClass.clear();
-
-    const auto& methods = this->getMethodsForClassName(selectedClassName);
-
-    for (const auto& method : methods)
-    {
-        QVariantMap methodMap = method.toMap();
-        QString name = methodMap["name"].toString();
-
-        if (name.contains(typedAfterColon, Qt::CaseInsensitive))
-        {
-            QString type = methodMap["type"].toString();
-            if (type == "value")
-            {
-                continue;
-            }
+    return this->methodsForSelectedClassModel;
+}
 
-            QVariantMap matchDetails;
-            matchDetails["name"] = name;
-            matchDetails["type"] = type;
-            matchDetails["description"] = methodMap["description"].toString();
-            matchDetails["args"] = methodMap["args"].toString();
-            matchDetails["returns"] = methodMap["returns"].toString();
-            matchDetails["valuetype"] = methodMap["valuetype"].toString();
-            matchDetails["startIndex"] = name.indexOf(typedAfterColon, 0, Qt::CaseInsensitive);
-            matchDetails["endIndex"] = matchDetails["startIndex"].toInt() + typedAfterColon.length() - 1;
-
-            this->methodsForSelectedClass.append(matchDetails);
-        }
-    }
+CompletionListModel* ApiModel::getConstantsForSelectedClassModel() const
+{
+    return this->constantsForSelectedClassModel;
+}
 
-    if (this->methodsForSelectedClass.isEmpty())
-    {
-        this->setSelectedClassName(this->selectedClassName);
-        this->closeIntellisense();
-    }
-    else
-    {
-        this->selectedClassName = selectedClassName;
-        Q_EMIT methodsForSelectedClassChanged();
-    }
+CompletionListModel* ApiModel::getMatchedVariablesModel() const
+{
+    return this->matchedVariablesModel;
 }
 
-void ApiModel::processMatchedConstantsForSelectedClass(const QString& selectedClassName, const QString& typedAfterKeyword)
+void ApiModel::showMatchedMethodsForClass(const ApiSnapshot& apiSnapshot, const QString& className, const QString& typedAfterColon, int mouseX, int mouseY)
 {
-    this->constantsForSelectedClass.clear();
+    const QVariantList matchedMethods = apiSnapshot.matchMethods(className, typedAfterColon);
 
-    // Only process if typedAfterKeyword has a sufficient length
-    // if (typedAfterKeyword.size() >= 3)
-    {
-        // Get all constants for the currently selected class
-        const auto& constants = this->getConstantsForClassName(selectedClassName);
+    // Direct on the gui thread, queued from the worker
+    QMetaObject::invokeMethod(this, [this, className, matchedMethods, mouseX, mouseY]()
+                              {
+                                  this->methodsForSelectedClass = matchedMethods;
 
-        // Check if constants are retrieved correctly
-        if (constants.isEmpty())
-        {
-            qDebug() << "No constants found for class:" << selectedClassName;
-            return; // Exit if no constants are found
-        }
+                                  if (this->methodsForSelectedClass.isEmpty())
+                                  {
+                                      this->closeIntellisense();
+                                  }
+                                  else
+                                  {
+                                      this->selectedClassName = className;
+                                      this->methodsForSelectedClassModel->setEntries(this->methodsForSelectedClass);
+                                      Q_EMIT methodsForSelectedClassChanged();
+                                  }
 
-        // Iterate through each constant and find matches
-        for (const auto& constant : constants)
-        {
-            QVariantMap constantMap = constant.toMap();
-            QString name = constantMap["name"].toString();
+                                  if (false == this->selectedClassName.isEmpty())
+                                  {
+                                      this->showIntelliSenseMenu("forClass", className, mouseX, mouseY);
+                                  }
+                              });
+}
 
-            // Check if the constant name contains the typed string
-            if (name.contains(typedAfterKeyword, Qt::CaseInsensitive))
-            {
-                // Create match details
-                QVariantMap matchDetails;
-                matchDetails["name"] = name;
+void ApiModel::showMatchedConstantsForClass(const ApiSnapshot& apiSnapshot, const QString& className, const QString& typedAfterKeyword, int mouseX, int mouseY)
+{
+    const QVariantList matchedConstants = apiSnapshot.matchConstants(className, typedAfterKeyword);
 
-                // Find the start and end indices of the match
-                int startIndex = name.indexOf(typedAfterKeyword, 0, Qt::CaseInsensitive);
-                int endIndex = startIndex + typedAfterKeyword.length() - 1;
+    // Direct on the gui thread, queued from the worker
+    QMetaObject::invokeMethod(this, [this, className, matchedConstants, mouseX, mouseY]()
+                              {
+                                  this->constantsForSelectedClass = matchedConstants;
 
-                matchDetails["startIndex"] = startIndex;
-                matchDetails["endIndex"] = endIndex;
+                                  // Emit signal only if there are matched constants
+                                  if (false == this->constantsForSelectedClass.isEmpty())
+                                  {
+                                      this->selectedClassName = className;
+                                      this->constantsForSelectedClassModel->setEntries(this->constantsForSelectedClass);
+                                      Q_EMIT constantsForSelectedClassChanged(); // Notify that the list of constants has changed
+                                  }
 
-                // Append the match details to the list
-                this->constantsForSelectedClass.append(matchDetails);
-            }
-        }
-    }
-
-    // Emit signal only if there are matched constants
-    if (this->constantsForSelectedClass.isEmpty())
-    {
-        this->setSelectedClassName(this->selectedClassName);
-    }
-    else
-    {
-        this->selectedClassName = selectedClassName;
-        Q_EMIT constantsForSelectedClassChanged(); // Notify that the list of constants has changed
-    }
+                                  this->showIntelliSenseMenu("forConstant", className, mouseX, mouseY);
+                              });
 }
 
 void ApiModel::setMatchedVariables(const QVariantMap& matchedVariables)
@@ -487,6 +416,7 @@ void ApiModel::setMatchedVariables(const QVariantMap& matchedVariables)
 
         if (!this->matchedVariables.isEmpty())
         {
+            this->matchedVariablesModel->setEntries(this->matchedVariables);
             Q_EMIT matchedVariablesChanged();
         }
     }, Qt::QueuedConnection);
@@ -494,19 +424,14 @@ void ApiModel::setMatchedVariables(const QVariantMap& matchedVariables)
 
 QString ApiModel::getClassForMethodName(const QString& className, const QString& methodName)
 {
-    const auto& methods = this->getMethodsForClassName(className);
-    for (const auto& method : methods)
-    {
-        QVariantMap methodMap = method.toMap();
+    const std::shared_ptr<const ApiSnapshot> apiSnapshot = this->getSnapshot();
 
-        // Check if the current method's name matches the requested method name
-        if (methodMap["name"].toString() == methodName)
-        {
-            QString returnedClassName = methodMap["returns"].toString();
-            return returnedClassName;
-        }
+    const MethodRecord* methodRecord = apiSnapshot->findMethod(className, methodName);
+    if (Q_NULLPTR == methodRecord)
+    {
+        return "";
     }
-    return "";
+    return methodRecord->returns;
 }
 
 void ApiModel::showIntelliSenseMenu(const QString& resultType, const QString& wordBeforeColon, int mouseX, int mouseY)
@@ -545,19 +470,7 @@ void ApiModel::showMatchedFunctionMenu(int mouseX, int mouseY)
 
 QVariantMap ApiModel::getMethodDetails(const QString& selectedClassName, const QString& methodName)
 {
-    const auto& methods = this->getMethodsForClassName(selectedClassName);
-    for (const auto& method : methods)
-    {
-        QVariantMap methodMap = method.toMap();
-
-        // Check if the current method's name matches the requested method name
-        if (methodMap["name"].toString() == methodName)
-        {
-            return methodMap;
-        }
-    }
-
-    return QVariantMap();
+    return this->getSnapshot()->getMethodDetails(selectedClassName, methodName);
 }
 
 bool ApiModel::getIsMatchedFunctionShown() const
@@ -578,23 +491,22 @@ void ApiModel::setIsMatchedFunctionShown(bool isMatchedFunctionShown)
 
 bool ApiModel::isValidClassName(const QString& className)
 {
-    if (this->apiData.contains(className))
-    {
-        return true;
-    }
-    return false;
+    return this->getSnapshot()->isValidClassName(className);
 }
 
 bool ApiModel::isValidMethodName(const QString& className, const QString& methodName)
 {
-    const auto& methodResult = this->getMethodDetails(className, methodName);
-    return !methodResult.isEmpty();
+    return Q_NULLPTR != this->getSnapshot()->findMethod(className, methodName);
 }
 
 void ApiModel::closeIntellisense()
 {
-    this->setIsIntellisenseShown(false);
-    Q_EMIT signal_closeIntellisense();
+    // Direct on the gui thread, queued from the worker
+    QMetaObject::invokeMethod(this, [this]()
+                              {
+                                  this->setIsIntellisenseShown(false);
+                                  Q_EMIT signal_closeIntellisense();
+                              });
 }
 
 void ApiModel::closeMatchedFunction()
@@ -4,8 +4,14 @@
 #include <QAbstractListModel>
 #include <QQmlEngine>
 #include <QMutex>
+#include <QHash>
+
+#include <atomic>
+#include <memory>
 
 #include "luascriptadapter.h"
+#include "apisnapshot.h"
+#include "completionlistmodel.h"
 
 class ApiModel : public QAbstractListModel
 {
@@ -21,11 +27,12 @@ public:
 
     Q_PROPERTY(QString selectedMethodName READ getSelectedMethodName WRITE setSelectedMethodName NOTIFY selectedMethodNameChanged FINAL)
 
-    Q_PROPERTY(QVariantList methodsForSelectedClass READ getMethodsForSelectedClass NOTIFY methodsForSelectedClassChanged)
+    // Diffed list models for the intellisense menu, see CompletionListModel
+    Q_PROPERTY(CompletionListModel* methodsForSelectedClass READ getMethodsForSelectedClassModel CONSTANT FINAL)
 
-    Q_PROPERTY(QVariantList constantsForSelectedClass READ getConstantsForSelectedClass NOTIFY constantsForSelectedClassChanged)
+    Q_PROPERTY(CompletionListModel* constantsForSelectedClass READ getConstantsForSelectedClassModel CONSTANT FINAL)
 
-    Q_PROPERTY(QVariantList matchedVariables READ getMatchedVariables NOTIFY matchedVariablesChanged)
+    Q_PROPERTY(CompletionListModel* matchedVariables READ getMatchedVariablesModel CONSTANT FINAL)
 
     Q_PROPERTY(bool isIntellisenseShown READ getIsIntellisenseShown WRITE setIsIntellisenseShown NOTIFY isIntellisenseShownChanged FINAL)
 
@@ -58,9 +65,18 @@ public:
         ClassInheritsRole
     };
 
+    using MethodRecord = ApiSnapshot::MethodRecord;
+
+    using ClassRecord = ApiSnapshot::ClassRecord;
+
+    using MemoryReport = ApiSnapshot::MemoryReport;
+
+    // Builds a new snapshot and swaps it in, gui thread only
     void setApiData(const QMap<QString, LuaScriptAdapter::ClassData>& apiData);
 
-    const QMap<QString, LuaScriptAdapter::ClassData>& getApiData(void) const;
+    // The current api, from any thread. Hold the snapshot for a whole pass, its records stay valid as long as it is held, even if the api
+    // is reloaded meanwhile.
+    std::shared_ptr<const ApiSnapshot> getSnapshot(void) const;
 
     virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
 
@@ -82,9 +98,17 @@ public:
 
     QVariantList getMatchedVariables() const;
 
-    void processMatchedMethodsForSelectedClass(const QString& selectedClassName, const QString& typedAfterColon);
+    CompletionListModel* getMethodsForSelectedClassModel() const;
 
-    void processMatchedConstantsForSelectedClass(const QString& selectedClassName, const QString& typedAfterKeyword);
+    CompletionListModel* getConstantsForSelectedClassModel() const;
+
+    CompletionListModel* getMatchedVariablesModel() const;
+
+    // Ranks the methods of the class on the calling thread, e.g. the intellisense worker, against the snapshot of its pass, the one
+    // the class has been matched in. The selection and the menu are updated on the gui thread.
+    void showMatchedMethodsForClass(const ApiSnapshot& apiSnapshot, const QString& className, const QString& typedAfterColon, int mouseX, int mouseY);
+
+    void showMatchedConstantsForClass(const ApiSnapshot& apiSnapshot, const QString& className, const QString& typedAfterKeyword, int mouseX, int mouseY);
 
     QString getClassForMethodName(const QString& className, const QString& methodName);
 
@@ -98,6 +122,7 @@ public:
 
     void showMatchedFunctionMenu(int mouseX, int mouseY);
 
+    // From any thread, the menu is closed on the gui thread
     void closeIntellisense(void);
 
     void closeMatchedFunction(void);
@@ -130,6 +155,7 @@ public:
 
     void setMatchedVariables(const QVariantMap& matchedVariables);
 
+    // For qml, cached by the snapshot
     QVariantList getMethodsForClassName(const QString& className);
 
     QVariantList getConstantsForClassName(const QString& className);
@@ -175,22 +201,29 @@ private:
 private:
     void extracted();
 
+    // The selection state below is gui state, these run on the gui thread only
     bool updateMethodsForSelectedClass(); // Helper function to update methods
 
     bool updateConstantsForSelectedClass(); // Helper function to update methods
 private:
-    QMap<QString, LuaScriptAdapter::ClassData> apiData;
+    // Replaced as a whole by setApiData, never null. The mutex only guards the pointer, copying it out is all a reader does under it.
+    std::shared_ptr<const ApiSnapshot> snapshot;
+    mutable QMutex snapshotMutex;
+
     QString selectedClassName;
     QString selectedMethodName;
     QVariantList methodsForSelectedClass;
     QVariantList constantsForSelectedClass;
     QVariantList matchedVariables;
+    CompletionListModel* methodsForSelectedClassModel;
+    CompletionListModel* constantsForSelectedClassModel;
+    CompletionListModel* matchedVariablesModel;
 
     QString classType;
     QString classDescription;
     QString classInherits;
 
-    bool isIntellisenseShown;
+    std::atomic<bool> isIntellisenseShown; // Asked by the intellisense worker too
     bool isMatchedFunctionShown;
 
     bool hasLuaApi;
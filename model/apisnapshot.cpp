@@ -0,0 +1,442 @@
+#include "apisnapshot.h"
+
+#include <QDebug>
+
+namespace
+{
+    // Heap bytes of a string, its data block with the header, which Qt allocates in front of the characters
+    qint64 stringBytes(const QString& value)
+    {
+        if (true == value.isNull())
+        {
+            return 0;
+        }
+        return 16 + value.capacity() * static_cast<qint64>(sizeof(QChar));
+    }
+
+    // More is not readable in the intellisense menu anyway
+    const int maxCompletionResults = 64;
+
+    // The qml menu highlights [startIndex, endIndex], if the match is contiguous, else the single matched positions
+    void setMatchedPositions(QVariantMap& matchDetails, const CompletionIndex::Match& match)
+    {
+        const QList<int>& positions = match.matchedPositions;
+        const bool contiguous = false == positions.isEmpty() && positions.last() - positions.first() == positions.size() - 1;
+
+        matchDetails["startIndex"] = true == positions.isEmpty() ? 0 : (true == contiguous ? positions.first() : -1);
+        matchDetails["endIndex"] = true == contiguous ? positions.last() : -1;
+
+        QVariantList matchedPositions;
+        matchedPositions.reserve(positions.size());
+        for (const int position : positions)
+        {
+            matchedPositions.append(position);
+        }
+        matchDetails["matchedPositions"] = matchedPositions;
+    }
+}
+
+ApiSnapshot::ApiSnapshot()
+{
+
+}
+
+ApiSnapshot::ApiSnapshot(const QMap<QString, LuaScriptAdapter::ClassData>& apiData)
+{
+    qsizetype methodCount = 0;
+    for (auto it = apiData.cbegin(); it != apiData.cend(); ++it)
+    {
+        methodCount += it.value().methods.size();
+    }
+
+    this->classRecords.reserve(apiData.size());
+    this->classIndices.reserve(apiData.size());
+    this->methodRecords.reserve(methodCount);
+
+    // The methods each class declares itself are [declaredBegins[i], declaredBegins[i + 1]) of the method records
+    QList<int> declaredBegins;
+    declaredBegins.reserve(apiData.size() + 1);
+
+    // The map is sorted by name, so are the rows
+    for (auto it = apiData.cbegin(); it != apiData.cend(); ++it)
+    {
+        const int classIndex = static_cast<int>(this->classRecords.size());
+        const LuaScriptAdapter::ClassData& classData = it.value();
+
+        ClassRecord classRecord;
+        classRecord.name = it.key();
+        classRecord.type = classData.type;
+        classRecord.description = classData.description;
+        classRecord.inherits = classData.inherits;
+
+        declaredBegins.append(static_cast<int>(this->methodRecords.size()));
+
+        for (auto methodIt = classData.methods.cbegin(); methodIt != classData.methods.cend(); ++methodIt)
+        {
+            const LuaScriptAdapter::MethodData& methodData = methodIt.value();
+
+            MethodRecord methodRecord;
+            methodRecord.name = methodIt.key();
+            methodRecord.type = methodData.type;
+            methodRecord.description = methodData.description;
+            methodRecord.args = methodData.args;
+            methodRecord.returns = methodData.returns;
+            methodRecord.valuetype = methodData.valuetype;
+            methodRecord.returnType = QString(methodData.returns).remove('(').remove(')');
+            methodRecord.isConstant = "value" == methodData.type; // Value types are constants and no methods
+            methodRecord.classIndex = classIndex;
+
+            this->methodRecords.append(methodRecord);
+        }
+
+        this->classIndices.insert(classRecord.name, classIndex);
+        this->classRecords.append(classRecord);
+    }
+    declaredBegins.append(static_cast<int>(this->methodRecords.size()));
+
+    const int classCount = static_cast<int>(this->classRecords.size());
+
+    // The members of each class: its own methods and those of its parents, which it does not override, only as indices of the shared records
+    for (int classIndex = 0; classIndex < classCount; ++classIndex)
+    {
+        // Sorted by name like the methods of a class have always been
+        QMap<QString, int> members;
+
+        // A cyclic chain ends after all classes, the parser has already warned about it
+        int current = classIndex;
+        for (int depth = 0; -1 != current && depth < classCount; ++depth)
+        {
+            for (int i = declaredBegins.at(current); i < declaredBegins.at(current + 1); ++i)
+            {
+                // The nearest declaration wins
+                const QString& name = this->methodRecords.at(i).name;
+                if (false == members.contains(name))
+                {
+                    members.insert(name, i);
+                }
+            }
+
+            current = this->classIndices.value(this->classRecords.at(current).inherits, -1);
+        }
+
+        ClassRecord& classRecord = this->classRecords[classIndex];
+        classRecord.methodBegin = static_cast<int>(this->memberTable.size());
+
+        QStringList methodNames;
+        QStringList constantNames;
+
+        // Methods first, then the constants
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            const bool constants = 1 == pass;
+
+            for (auto memberIt = members.cbegin(); memberIt != members.cend(); ++memberIt)
+            {
+                if (constants != this->methodRecords.at(memberIt.value()).isConstant)
+                {
+                    continue;
+                }
+
+                this->methodIndices.insert(MethodKey{ classIndex, memberIt.key() }, memberIt.value());
+                this->memberTable.append(memberIt.value());
+
+                if (true == constants)
+                {
+                    constantNames.append(memberIt.key());
+                }
+                else
+                {
+                    methodNames.append(memberIt.key());
+                }
+            }
+
+            if (false == constants)
+            {
+                classRecord.methodEnd = static_cast<int>(this->memberTable.size());
+            }
+        }
+
+        classRecord.constantEnd = static_cast<int>(this->memberTable.size());
+
+        this->methodCompletions.append(CompletionIndex());
+        this->methodCompletions.last().build(methodNames);
+        this->constantCompletions.append(CompletionIndex());
+        this->constantCompletions.last().build(constantNames);
+    }
+
+    // Each declaration once, so a name is found at the class, which declares it
+    QStringList symbolNames;
+    symbolNames.reserve(this->methodRecords.size());
+    for (const MethodRecord& methodRecord : this->methodRecords)
+    {
+        symbolNames.append(methodRecord.name);
+    }
+    this->symbolIndex.build(symbolNames);
+}
+
+int ApiSnapshot::getClassCount(void) const
+{
+    return static_cast<int>(this->classRecords.size());
+}
+
+const ApiSnapshot::ClassRecord& ApiSnapshot::getClassAt(int index) const
+{
+    return this->classRecords.at(index);
+}
+
+const ApiSnapshot::ClassRecord* ApiSnapshot::findClass(const QString& className) const
+{
+    const auto it = this->classIndices.constFind(className);
+    if (this->classIndices.constEnd() == it)
+    {
+        return Q_NULLPTR;
+    }
+    return &this->classRecords.at(it.value());
+}
+
+bool ApiSnapshot::isValidClassName(const QString& className) const
+{
+    return this->classIndices.contains(className);
+}
+
+const ApiSnapshot::MethodRecord* ApiSnapshot::findMember(const QString& className, const QString& name, bool constant) const
+{
+    const auto classIt = this->classIndices.constFind(className);
+    if (this->classIndices.constEnd() == classIt)
+    {
+        return Q_NULLPTR;
+    }
+
+    const auto methodIt = this->methodIndices.constFind(MethodKey{ classIt.value(), name });
+    if (this->methodIndices.constEnd() == methodIt)
+    {
+        return Q_NULLPTR;
+    }
+
+    const MethodRecord& methodRecord = this->methodRecords.at(methodIt.value());
+    if (constant != methodRecord.isConstant)
+    {
+        return Q_NULLPTR;
+    }
+    return &methodRecord;
+}
+
+const ApiSnapshot::MethodRecord* ApiSnapshot::findMethod(const QString& className, const QString& methodName) const
+{
+    return this->findMember(className, methodName, false);
+}
+
+const ApiSnapshot::MethodRecord* ApiSnapshot::findConstant(const QString& className, const QString& constantName) const
+{
+    return this->findMember(className, constantName, true);
+}
+
+const ApiSnapshot::MethodRecord& ApiSnapshot::getMethodAt(int index) const
+{
+    return this->methodRecords.at(index);
+}
+
+bool ApiSnapshot::hasMethods(const QString& className) const
+{
+    const ClassRecord* classRecord = this->findClass(className);
+    return Q_NULLPTR != classRecord && classRecord->methodEnd > classRecord->methodBegin;
+}
+
+bool ApiSnapshot::hasConstants(const QString& className) const
+{
+    const ClassRecord* classRecord = this->findClass(className);
+    return Q_NULLPTR != classRecord && classRecord->constantEnd > classRecord->methodEnd;
+}
+
+QVariantMap ApiSnapshot::getMethodDetails(const QString& className, const QString& methodName) const
+{
+    const MethodRecord* methodRecord = this->findMethod(className, methodName);
+    if (Q_NULLPTR == methodRecord)
+    {
+        return QVariantMap();
+    }
+    return toVariantMap(*methodRecord);
+}
+
+QVariantList ApiSnapshot::matchMethods(const QString& className, const QString& typedAfterColon) const
+{
+    QVariantList matchedMethods;
+
+    const auto classIt = this->classIndices.constFind(className);
+    if (this->classIndices.constEnd() == classIt)
+    {
+        return matchedMethods;
+    }
+
+    const ClassRecord& classRecord = this->classRecords.at(classIt.value());
+
+    // Best first, prefix matches before camel hump and other fuzzy matches
+    const QList<CompletionIndex::Match> matches = this->methodCompletions.at(classIt.value()).match(typedAfterColon, maxCompletionResults);
+
+    matchedMethods.reserve(matches.size());
+    for (const CompletionIndex::Match& match : matches)
+    {
+        QVariantMap matchDetails = toVariantMap(this->methodRecords.at(this->memberTable.at(classRecord.methodBegin + match.index)));
+        setMatchedPositions(matchDetails, match);
+
+        matchedMethods.append(matchDetails);
+    }
+    return matchedMethods;
+}
+
+QVariantList ApiSnapshot::matchConstants(const QString& className, const QString& typedAfterKeyword) const
+{
+    QVariantList matchedConstants;
+
+    const auto classIt = this->classIndices.constFind(className);
+    if (this->classIndices.constEnd() == classIt || false == this->hasConstants(className))
+    {
+        qDebug() << "No constants found for class:" << className;
+        return matchedConstants;
+    }
+
+    const ClassRecord& classRecord = this->classRecords.at(classIt.value());
+
+    // Ranked like the methods, best first
+    const QList<CompletionIndex::Match> matches = this->constantCompletions.at(classIt.value()).match(typedAfterKeyword, maxCompletionResults);
+
+    matchedConstants.reserve(matches.size());
+    for (const CompletionIndex::Match& match : matches)
+    {
+        QVariantMap matchDetails;
+        matchDetails["name"] = this->methodRecords.at(this->memberTable.at(classRecord.methodEnd + match.index)).name;
+        setMatchedPositions(matchDetails, match);
+
+        matchedConstants.append(matchDetails);
+    }
+    return matchedConstants;
+}
+
+QList<int> ApiSnapshot::findSymbols(const QString& text, int maxResults) const
+{
+    return this->symbolIndex.find(text, maxResults);
+}
+
+ApiSnapshot::MemoryReport ApiSnapshot::getMemoryReport(void) const
+{
+    MemoryReport memoryReport;
+    memoryReport.classCount = static_cast<int>(this->classRecords.size());
+    memoryReport.methodCount = static_cast<int>(this->methodRecords.size());
+    memoryReport.memberCount = static_cast<int>(this->memberTable.size());
+
+    memoryReport.containerBytes = this->classRecords.capacity() * static_cast<qint64>(sizeof(ClassRecord))
+                                  + this->methodRecords.capacity() * static_cast<qint64>(sizeof(MethodRecord));
+
+    memoryReport.memberTableBytes = this->memberTable.capacity() * static_cast<qint64>(sizeof(int));
+
+    // A copy of an inherited record would share the strings of the parent, but not the detached return type
+    qint64 inheritedCopyBytes = 0;
+
+    for (int classIndex = 0; classIndex < this->classRecords.size(); ++classIndex)
+    {
+        const ClassRecord& classRecord = this->classRecords.at(classIndex);
+        memoryReport.stringBytes += stringBytes(classRecord.name) + stringBytes(classRecord.type) + stringBytes(classRecord.description) + stringBytes(classRecord.inherits);
+
+        for (int i = classRecord.methodBegin; i < classRecord.constantEnd; ++i)
+        {
+            const MethodRecord& methodRecord = this->methodRecords.at(this->memberTable.at(i));
+            if (classIndex != methodRecord.classIndex)
+            {
+                inheritedCopyBytes += static_cast<qint64>(sizeof(MethodRecord)) + stringBytes(methodRecord.returnType);
+            }
+        }
+    }
+
+    for (const MethodRecord& methodRecord : this->methodRecords)
+    {
+        memoryReport.stringBytes += stringBytes(methodRecord.name) + stringBytes(methodRecord.type) + stringBytes(methodRecord.description)
+                                    + stringBytes(methodRecord.args) + stringBytes(methodRecord.returns) + stringBytes(methodRecord.valuetype)
+                                    + stringBytes(methodRecord.returnType);
+    }
+
+    // The keys share their data with the names of the records, only the buckets count
+    memoryReport.indexBytes = this->classIndices.capacity() * static_cast<qint64>(sizeof(QString) + sizeof(int) + 1)
+                              + this->methodIndices.capacity() * static_cast<qint64>(sizeof(MethodKey) + sizeof(int) + 1);
+
+    memoryReport.symbolIndexBytes = this->symbolIndex.getMemoryBytes();
+
+    memoryReport.totalBytes = memoryReport.stringBytes + memoryReport.containerBytes + memoryReport.memberTableBytes + memoryReport.indexBytes + memoryReport.symbolIndexBytes;
+
+    // Instead of the member table, one record per inherited member
+    memoryReport.estimatedCopiedLayoutBytes = memoryReport.totalBytes - memoryReport.memberTableBytes + inheritedCopyBytes;
+    return memoryReport;
+}
+
+QVariantList ApiSnapshot::getMethodsForClassName(const QString& className) const
+{
+    const auto classIt = this->classIndices.constFind(className);
+    if (this->classIndices.constEnd() == classIt)
+    {
+        return QVariantList();
+    }
+
+    QMutexLocker lock(&this->variantCacheMutex);
+
+    auto cacheIt = this->methodVariantCache.constFind(classIt.value());
+    if (this->methodVariantCache.constEnd() != cacheIt)
+    {
+        return cacheIt.value();
+    }
+
+    const ClassRecord& classRecord = this->classRecords.at(classIt.value());
+
+    QVariantList methods;
+    methods.reserve(classRecord.methodEnd - classRecord.methodBegin);
+
+    for (int i = classRecord.methodBegin; i < classRecord.methodEnd; ++i)
+    {
+        methods.append(toVariantMap(this->methodRecords.at(this->memberTable.at(i))));
+    }
+
+    this->methodVariantCache.insert(classIt.value(), methods);
+    return methods;
+}
+
+QVariantList ApiSnapshot::getConstantsForClassName(const QString& className) const
+{
+    const auto classIt = this->classIndices.constFind(className);
+    if (this->classIndices.constEnd() == classIt)
+    {
+        return QVariantList();
+    }
+
+    QMutexLocker lock(&this->variantCacheMutex);
+
+    auto cacheIt = this->constantVariantCache.constFind(classIt.value());
+    if (this->constantVariantCache.constEnd() != cacheIt)
+    {
+        return cacheIt.value();
+    }
+
+    const ClassRecord& classRecord = this->classRecords.at(classIt.value());
+
+    QVariantList constants;
+    constants.reserve(classRecord.constantEnd - classRecord.methodEnd);
+
+    for (int i = classRecord.methodEnd; i < classRecord.constantEnd; ++i)
+    {
+        QVariantMap constantMap;
+        constantMap["name"] = this->methodRecords.at(this->memberTable.at(i)).name;
+        constants.append(constantMap);
+    }
+
+    this->constantVariantCache.insert(classIt.value(), constants);
+    return constants;
+}
+
+QVariantMap ApiSnapshot::toVariantMap(const MethodRecord& methodRecord)
+{
+    QVariantMap methodMap;
+    methodMap["name"] = methodRecord.name;
+    methodMap["type"] = methodRecord.type;
+    methodMap["description"] = methodRecord.description;
+    methodMap["args"] = methodRecord.args;
+    methodMap["returns"] = methodRecord.returns;
+    methodMap["valuetype"] = methodRecord.valuetype;
+    return methodMap;
+}
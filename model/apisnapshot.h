@@ -0,0 +1,154 @@
+#ifndef APISNAPSHOT_H
+#define APISNAPSHOT_H
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QVariantMap>
+
+#include "luascriptadapter.h"
+#include "completionindex.h"
+#include "symbolindex.h"
+
+// The parsed lua api of one load: the classes, their methods and constants and the indices over them. It is built at once and never
+// changed afterwards. A reload of the api builds a new snapshot, which the ApiModel swaps in, while readers still holding the old one
+// keep it alive. So any thread, e.g. the intellisense worker, may query a held snapshot without a lock.
+class ApiSnapshot
+{
+public:
+    // A method or constant, as the class declares it. Subclasses, which inherit it, share this record.
+    struct MethodRecord
+    {
+        QString name;
+        QString type;
+        QString description;
+        QString args;
+        QString returns;
+        QString valuetype;
+        QString returnType; // returns without the brackets, the class for the next link of a method chain
+        bool isConstant = false; // type "value"
+        int classIndex = -1; // The declaring class
+    };
+
+    // One class of the api, the row of the ApiModel is its index in the flat array.
+    // Its methods and then its constants, the inherited ones included, are the ranges [methodBegin, methodEnd) and [methodEnd, constantEnd)
+    // of the member table.
+    struct ClassRecord
+    {
+        QString name;
+        QString type;
+        QString description;
+        QString inherits;
+        int methodBegin = 0;
+        int methodEnd = 0;
+        int constantEnd = 0;
+    };
+
+    // Estimated heap bytes of the api, strings with their capacity, containers with their nodes
+    struct MemoryReport
+    {
+        int classCount = 0;
+        int methodCount = 0; // Method records, each declaration once
+        int memberCount = 0; // Member table entries, the methods of each class with the inherited ones
+        qint64 memberTableBytes = 0;
+        // Not measured, the old layout is not built anymore: the total above without the member table, plus one record and
+        // return type per inherited member
+        qint64 estimatedCopiedLayoutBytes = 0;
+        qint64 stringBytes = 0;
+        qint64 containerBytes = 0;
+        qint64 indexBytes = 0;
+        qint64 symbolIndexBytes = 0;
+        qint64 totalBytes = 0;
+    };
+public:
+    // No api loaded yet
+    ApiSnapshot();
+
+    explicit ApiSnapshot(const QMap<QString, LuaScriptAdapter::ClassData>& apiData);
+
+    ApiSnapshot(const ApiSnapshot&) = delete;
+
+    ApiSnapshot& operator=(const ApiSnapshot&) = delete;
+
+    int getClassCount(void) const;
+
+    const ClassRecord& getClassAt(int index) const;
+
+    // O(1), Q_NULLPTR if there is no such class
+    const ClassRecord* findClass(const QString& className) const;
+
+    bool isValidClassName(const QString& className) const;
+
+    // O(1) by class and name, Q_NULLPTR if the class has no such method. Constants are not found as methods and vice versa.
+    const MethodRecord* findMethod(const QString& className, const QString& methodName) const;
+
+    const MethodRecord* findConstant(const QString& className, const QString& constantName) const;
+
+    // index of a method record, e.g. found by findSymbols
+    const MethodRecord& getMethodAt(int index) const;
+
+    bool hasMethods(const QString& className) const;
+
+    bool hasConstants(const QString& className) const;
+
+    // Empty, if the class has no such method
+    QVariantMap getMethodDetails(const QString& className, const QString& methodName) const;
+
+    // The methods of the class, which match the typed text, best first, as the rows of the intellisense menu
+    QVariantList matchMethods(const QString& className, const QString& typedAfterColon) const;
+
+    QVariantList matchConstants(const QString& className, const QString& typedAfterKeyword) const;
+
+    // Method record indices of all classes, whose method or constant name contains the text, see SymbolIndex::find
+    QList<int> findSymbols(const QString& text, int maxResults = 200) const;
+
+    MemoryReport getMemoryReport(void) const;
+
+    // For qml, built on the first request per class and cached as long as the snapshot lives
+    QVariantList getMethodsForClassName(const QString& className) const;
+
+    QVariantList getConstantsForClassName(const QString& className) const;
+
+    static QVariantMap toVariantMap(const MethodRecord& methodRecord);
+private:
+    const MethodRecord* findMember(const QString& className, const QString& name, bool constant) const;
+private:
+    struct MethodKey
+    {
+        int classIndex;
+        QString name;
+
+        bool operator==(const MethodKey& other) const
+        {
+            return this->classIndex == other.classIndex && this->name == other.name;
+        }
+
+        friend size_t qHash(const MethodKey& key, size_t seed)
+        {
+            return qHashMulti(seed, key.classIndex, key.name);
+        }
+    };
+private:
+    // Sorted by class name like the parsed map, so that the rows keep their order
+    QList<ClassRecord> classRecords;
+    QHash<QString, int> classIndices;
+    QList<MethodRecord> methodRecords;
+    // Method record indices, per class its own and the inherited members, a class overrides the ones of its parents
+    QList<int> memberTable;
+    QHash<MethodKey, int> methodIndices; // By class and name to the method record
+
+    // Per class index, rank the typed text for the intellisense
+    QList<CompletionIndex> methodCompletions;
+    QList<CompletionIndex> constantCompletions;
+
+    // Over all method records, to find the classes of a name
+    SymbolIndex symbolIndex;
+
+    // The only state, which changes after the build. The queries above do not touch it.
+    mutable QMutex variantCacheMutex;
+    mutable QHash<int, QVariantList> methodVariantCache;
+    mutable QHash<int, QVariantList> constantVariantCache;
+};
+
+#endif // APISNAPSHOT_H
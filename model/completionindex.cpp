@@ -0,0 +1,403 @@
+#include "completionindex.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Score bonuses, a matched character is worth more, if it starts a word or continues the previous match
+    const int matchedScore = 16;
+    const int consecutiveScore = 16;
+    const int humpScore = 24;
+    const int firstCharacterScore = 32;
+    const int maxGapPenalty = 8;
+    const int prefixScore = 1000;
+    const int exactScore = 1000;
+
+    // The shift-and automaton keeps one bit per typed character
+    const int maxFuzzyLength = 64;
+}
+
+void CompletionIndex::build(const QStringList& names)
+{
+    this->names.clear();
+    this->bags.clear();
+    this->sortedNames.clear();
+    this->trieNodes.clear();
+
+    this->names.reserve(names.size());
+    this->bags.reserve(names.size());
+    this->sortedNames.reserve(names.size());
+
+    for (const QString& name : names)
+    {
+        Name entry;
+        entry.name = name;
+        entry.folded = name.toLower();
+
+        // Positions must match the name, lua names are ascii anyway
+        if (entry.folded.size() != name.size())
+        {
+            entry.folded = name;
+        }
+
+        this->sortedNames.append(static_cast<int>(this->names.size()));
+        this->bags.append(characterBag(entry.folded));
+        this->names.append(entry);
+    }
+
+    std::stable_sort(this->sortedNames.begin(), this->sortedNames.end(), [this](int left, int right)
+                     {
+                         return this->names[left].folded < this->names[right].folded;
+                     });
+
+    TrieNode root;
+    root.nameCount = static_cast<int>(this->names.size());
+    this->trieNodes.append(root);
+
+    // Inserted in sorted order, the names below each node are a contiguous range of sortedNames
+    for (int sortedIndex = 0; sortedIndex < this->sortedNames.size(); ++sortedIndex)
+    {
+        const QString& folded = this->names[this->sortedNames[sortedIndex]].folded;
+
+        int node = 0;
+        for (const QChar character : folded)
+        {
+            int child = this->trieNodes[node].firstChild;
+            int lastChild = -1;
+            while (-1 != child && this->trieNodes[child].character != character)
+            {
+                lastChild = child;
+                child = this->trieNodes[child].nextSibling;
+            }
+
+            if (-1 == child)
+            {
+                TrieNode trieNode;
+                trieNode.character = character;
+                trieNode.firstName = sortedIndex;
+
+                child = static_cast<int>(this->trieNodes.size());
+                this->trieNodes.append(trieNode);
+
+                if (-1 == lastChild)
+                {
+                    this->trieNodes[node].firstChild = child;
+                }
+                else
+                {
+                    this->trieNodes[lastChild].nextSibling = child;
+                }
+            }
+
+            ++this->trieNodes[child].nameCount;
+            node = child;
+        }
+    }
+}
+
+QList<CompletionIndex::Match> CompletionIndex::match(const QString& typed, int maxResults) const
+{
+    QList<Match> matches;
+
+    if (true == typed.isEmpty())
+    {
+        matches.reserve(this->names.size());
+        for (int i = 0; i < this->names.size(); ++i)
+        {
+            Match match;
+            match.index = i;
+            matches.append(match);
+        }
+        return matches;
+    }
+
+    QString foldedTyped = typed.toLower();
+    if (foldedTyped.size() != typed.size())
+    {
+        foldedTyped = typed;
+    }
+    const int prefixNode = this->findPrefixNode(foldedTyped);
+
+    auto matchPrefixRange = [&]()
+    {
+        const TrieNode& trieNode = this->trieNodes[prefixNode];
+        for (int i = trieNode.firstName; i < trieNode.firstName + trieNode.nameCount; ++i)
+        {
+            Match match;
+            if (true == this->scoreCandidate(this->sortedNames[i], typed, foldedTyped, match))
+            {
+                matches.append(match);
+            }
+        }
+    };
+
+    if (-1 != prefixNode && maxResults > 0 && this->trieNodes[prefixNode].nameCount >= maxResults)
+    {
+        // Enough names start with the typed text, they outrank every fuzzy match
+        matchPrefixRange();
+    }
+    else if (foldedTyped.size() <= maxFuzzyLength)
+    {
+        const quint64 typedBag = characterBag(foldedTyped);
+
+        // Bit j of the mask of a character is set, if the typed text has it at j
+        quint64 typedMasks[64] = {};
+        for (int j = 0; j < foldedTyped.size(); ++j)
+        {
+            typedMasks[characterBit(foldedTyped[j])] |= quint64(1) << j;
+        }
+        const quint64 acceptBit = quint64(1) << (foldedTyped.size() - 1);
+
+        const quint64* bags = this->bags.constData();
+        const int nameCount = static_cast<int>(this->names.size());
+
+        for (int i = 0; i < nameCount; ++i)
+        {
+            // A typed character, which the name does not have at all
+            if (0 != (typedBag & ~bags[i]))
+            {
+                continue;
+            }
+
+            // Bit j is set, once the first j + 1 typed characters have been found in order
+            quint64 state = 0;
+            for (const QChar character : this->names[i].folded)
+            {
+                state |= ((state << 1) | 1) & typedMasks[characterBit(character)];
+                if (0 != (state & acceptBit))
+                {
+                    break;
+                }
+            }
+
+            if (0 == (state & acceptBit))
+            {
+                continue;
+            }
+
+            Match match;
+            if (true == this->scoreCandidate(i, typed, foldedTyped, match))
+            {
+                matches.append(match);
+            }
+        }
+    }
+    else if (-1 != prefixNode)
+    {
+        // Too long for the automaton, only names, which start with it
+        matchPrefixRange();
+    }
+
+    const int resultCount = maxResults > 0 ? qMin(maxResults, static_cast<int>(matches.size())) : static_cast<int>(matches.size());
+
+    std::partial_sort(matches.begin(), matches.begin() + resultCount, matches.end(), [this](const Match& left, const Match& right)
+                      {
+                          if (left.score != right.score)
+                          {
+                              return left.score > right.score;
+                          }
+                          // Shorter names first, then the order of the api
+                          const qsizetype leftSize = this->names[left.index].name.size();
+                          const qsizetype rightSize = this->names[right.index].name.size();
+                          if (leftSize != rightSize)
+                          {
+                              return leftSize < rightSize;
+                          }
+                          return left.index < right.index;
+                      });
+
+    matches.resize(resultCount);
+    return matches;
+}
+
+int CompletionIndex::getNameCount(void) const
+{
+    return static_cast<int>(this->names.size());
+}
+
+int CompletionIndex::characterBit(QChar character)
+{
+    const char16_t unicode = character.unicode();
+    if (unicode >= u'a' && unicode <= u'z')
+    {
+        return unicode - u'a';
+    }
+    if (unicode >= u'A' && unicode <= u'Z')
+    {
+        return unicode - u'A';
+    }
+    if (unicode >= u'0' && unicode <= u'9')
+    {
+        return 26 + (unicode - u'0');
+    }
+    if (u'_' == unicode)
+    {
+        return 36;
+    }
+    // Anything else shares the remaining bits, the scorer sorts out the collisions
+    return 37 + unicode % 27;
+}
+
+quint64 CompletionIndex::characterBag(const QString& folded)
+{
+    quint64 bag = 0;
+    for (const QChar character : folded)
+    {
+        bag |= quint64(1) << characterBit(character);
+    }
+    return bag;
+}
+
+bool CompletionIndex::isHump(const QString& name, int position)
+{
+    if (0 == position)
+    {
+        return true;
+    }
+
+    const QChar previous = name[position - 1];
+    const QChar current = name[position];
+
+    if (u'_' == current)
+    {
+        return false;
+    }
+    if (u'_' == previous)
+    {
+        return true;
+    }
+    if (true == current.isDigit())
+    {
+        return false == previous.isDigit();
+    }
+    if (true == previous.isDigit())
+    {
+        return true;
+    }
+    if (true == current.isUpper())
+    {
+        // getPhysics, but also the P of XMLParser
+        return false == previous.isUpper() || (position + 1 < name.size() && name[position + 1].isLower());
+    }
+    return false;
+}
+
+int CompletionIndex::scoreWalk(const Name& name, const QString& typed, const QString& foldedTyped, bool preferHumps, QList<int>& matchedPositions)
+{
+    matchedPositions.clear();
+
+    const qsizetype nameSize = name.folded.size();
+    int score = 0;
+    int namePosition = 0;
+    int previous = -1;
+
+    for (int j = 0; j < foldedTyped.size(); ++j)
+    {
+        const QChar character = foldedTyped[j];
+        int position = -1;
+
+        // An upper case character asks for the next word, even if the current run could go on
+        const bool humpFirst = true == preferHumps && true == typed[j].isUpper();
+
+        // Continue the current run, e.g. "Phys" of getPhysicsActiveComponent
+        if (false == humpFirst && -1 != previous && namePosition < nameSize && name.folded[namePosition] == character)
+        {
+            position = namePosition;
+        }
+
+        // Jump to the next word, which starts with it, e.g. "gPAC"
+        if (-1 == position && true == preferHumps)
+        {
+            for (int k = namePosition; k < nameSize; ++k)
+            {
+                if (name.folded[k] == character && true == isHump(name.name, k))
+                {
+                    position = k;
+                    break;
+                }
+            }
+        }
+
+        if (-1 == position)
+        {
+            position = static_cast<int>(name.folded.indexOf(character, namePosition));
+            if (-1 == position)
+            {
+                return -1;
+            }
+        }
+
+        score += matchedScore;
+        if (-1 != previous && position == previous + 1)
+        {
+            score += consecutiveScore;
+        }
+        if (true == isHump(name.name, position))
+        {
+            score += 0 == position ? firstCharacterScore : humpScore;
+        }
+        score -= qMin(position - namePosition, maxGapPenalty);
+        if (typed[j] == name.name[position])
+        {
+            score += 1;
+        }
+
+        matchedPositions.append(position);
+        previous = position;
+        namePosition = position + 1;
+    }
+
+    return score;
+}
+
+int CompletionIndex::findPrefixNode(const QString& foldedTyped) const
+{
+    if (true == this->trieNodes.isEmpty())
+    {
+        return -1;
+    }
+
+    int node = 0;
+    for (const QChar character : foldedTyped)
+    {
+        int child = this->trieNodes[node].firstChild;
+        while (-1 != child && this->trieNodes[child].character != character)
+        {
+            child = this->trieNodes[child].nextSibling;
+        }
+
+        if (-1 == child)
+        {
+            return -1;
+        }
+        node = child;
+    }
+    return node;
+}
+
+bool CompletionIndex::scoreCandidate(int index, const QString& typed, const QString& foldedTyped, Match& match) const
+{
+    const Name& name = this->names[index];
+
+    // The hump walk may jump over characters, which a later typed character needs, the plain walk never misses a subsequence
+    match.score = scoreWalk(name, typed, foldedTyped, true, match.matchedPositions);
+    if (-1 == match.score)
+    {
+        match.score = scoreWalk(name, typed, foldedTyped, false, match.matchedPositions);
+        if (-1 == match.score)
+        {
+            return false;
+        }
+    }
+    match.index = index;
+
+    if (true == name.folded.startsWith(foldedTyped))
+    {
+        match.score += prefixScore;
+        if (name.folded.size() == foldedTyped.size())
+        {
+            match.score += exactScore;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef COMPLETIONINDEX_H
+#define COMPLETIONINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+// Ranks the methods or constants of one class against the typed text of the intellisense. Built once per class, when the api is set.
+// Names, which start with the typed text, are found by a prefix trie and rank first. All other names are matched as a fuzzy
+// subsequence, which knows camel humps, e.g. "gPAC" matches getPhysicsActiveComponent.
+// The subsequence test is bit-parallel: a 64 bit mask of the characters of each name sorts out most names with one and,
+// for the rest a shift-and automaton of the typed text runs over the name. Only the remaining candidates are scored.
+class CompletionIndex
+{
+public:
+    struct Match
+    {
+        int index = -1; // Of the name, in the order given to build
+        int score = 0;
+        QList<int> matchedPositions; // Characters of the name, which have been matched, ascending
+    };
+public:
+    void build(const QStringList& names);
+
+    // The best maxResults names, best first. An empty text matches all names in their order.
+    QList<Match> match(const QString& typed, int maxResults = 64) const;
+
+    int getNameCount(void) const;
+private:
+    struct Name
+    {
+        QString name;
+        QString folded; // Lower case
+    };
+
+    struct TrieNode
+    {
+        QChar character; // Lower case
+        int firstChild = -1;
+        int nextSibling = -1;
+        int firstName = 0; // The names below this node are [firstName, firstName + nameCount) of sortedNames
+        int nameCount = 0;
+    };
+
+    static int characterBit(QChar character);
+
+    static quint64 characterBag(const QString& folded);
+
+    static bool isHump(const QString& name, int position);
+
+    // -1 if the name does not contain the typed text as subsequence
+    static int scoreWalk(const Name& name, const QString& typed, const QString& foldedTyped, bool preferHumps, QList<int>& matchedPositions);
+
+    // The trie node of the typed prefix, -1 if no name starts with it
+    int findPrefixNode(const QString& foldedTyped) const;
+
+    bool scoreCandidate(int index, const QString& typed, const QString& foldedTyped, Match& match) const;
+private:
+    QList<Name> names;
+    QList<quint64> bags; // One per name, kept apart, so that the prefilter scans a plain array
+    QList<int> sortedNames; // Name indices sorted by the lower case name, the trie ranges point into it
+    QList<TrieNode> trieNodes; // [0] is the root
+};
+
+#endif // COMPLETIONINDEX_H
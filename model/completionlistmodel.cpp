@@ -0,0 +1,195 @@
+#include "completionlistmodel.h"
+
+#include <QSet>
+
+namespace
+{
+    // The role names are the keys of the entries
+    const QHash<int, QByteArray>& completionRoleNames(void)
+    {
+        static const QHash<int, QByteArray> roles =
+        {
+            { CompletionListModel::NameRole, "name" },
+            { CompletionListModel::TypeRole, "type" },
+            { CompletionListModel::DescriptionRole, "description" },
+            { CompletionListModel::ArgsRole, "args" },
+            { CompletionListModel::ReturnsRole, "returns" },
+            { CompletionListModel::ValueTypeRole, "valuetype" },
+            { CompletionListModel::ScopeRole, "scope" },
+            { CompletionListModel::StartIndexRole, "startIndex" },
+            { CompletionListModel::EndIndexRole, "endIndex" },
+            { CompletionListModel::MatchedPositionsRole, "matchedPositions" }
+        };
+        return roles;
+    }
+}
+
+CompletionListModel::CompletionListModel(QObject* parent)
+    : QAbstractListModel{parent}
+{
+
+}
+
+int CompletionListModel::rowCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return static_cast<int>(this->rows.size());
+}
+
+QVariant CompletionListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= this->rows.size())
+    {
+        return QVariant();
+    }
+
+    const auto roleIt = completionRoleNames().constFind(role);
+    if (completionRoleNames().constEnd() == roleIt)
+    {
+        return QVariant();
+    }
+    return this->rows[index.row()].value(QString::fromLatin1(roleIt.value()));
+}
+
+QHash<int, QByteArray> CompletionListModel::roleNames() const
+{
+    return completionRoleNames();
+}
+
+int CompletionListModel::getCount(void) const
+{
+    return static_cast<int>(this->rows.size());
+}
+
+QVariantMap CompletionListModel::get(int row) const
+{
+    if (row < 0 || row >= this->rows.size())
+    {
+        return QVariantMap();
+    }
+    return this->rows[row];
+}
+
+void CompletionListModel::setEntries(const QVariantList& entries)
+{
+    QList<QVariantMap> newRows;
+    newRows.reserve(entries.size());
+    for (const QVariant& entry : entries)
+    {
+        newRows.append(entry.toMap());
+    }
+
+    const QStringList newKeys = makeKeys(newRows);
+    const QSet<QString> newKeySet(newKeys.cbegin(), newKeys.cend());
+    const qsizetype oldCount = this->rows.size();
+
+    // Rows, which are gone, from the back, so that the rows before keep their index. A run of them at once.
+    int row = static_cast<int>(this->rows.size()) - 1;
+    while (row >= 0)
+    {
+        if (true == newKeySet.contains(this->keys[row]))
+        {
+            --row;
+            continue;
+        }
+
+        const int last = row;
+        while (row >= 0 && false == newKeySet.contains(this->keys[row]))
+        {
+            --row;
+        }
+
+        beginRemoveRows(QModelIndex(), row + 1, last);
+        this->rows.remove(row + 1, last - row);
+        this->keys.remove(row + 1, last - row);
+        endRemoveRows();
+    }
+
+    // All remaining rows are part of the new result, the rows above i are in their new order already
+    const QSet<QString> keptKeys(this->keys.cbegin(), this->keys.cend());
+
+    for (int i = 0; i < newRows.size(); ++i)
+    {
+        if (i < this->keys.size() && this->keys[i] == newKeys[i])
+        {
+            this->updateRow(i, newRows[i]);
+            continue;
+        }
+
+        if (true == keptKeys.contains(newKeys[i]))
+        {
+            // Ranked higher than before, it is further down
+            const int from = static_cast<int>(this->keys.indexOf(newKeys[i], i + 1));
+
+            beginMoveRows(QModelIndex(), from, from, QModelIndex(), i);
+            this->rows.move(from, i);
+            this->keys.move(from, i);
+            endMoveRows();
+
+            this->updateRow(i, newRows[i]);
+            continue;
+        }
+
+        // A run of new rows at once
+        int last = i;
+        while (last + 1 < newRows.size() && false == keptKeys.contains(newKeys[last + 1]))
+        {
+            ++last;
+        }
+
+        beginInsertRows(QModelIndex(), i, last);
+        for (int k = i; k <= last; ++k)
+        {
+            this->rows.insert(k, newRows[k]);
+            this->keys.insert(k, newKeys[k]);
+        }
+        endInsertRows();
+
+        i = last;
+    }
+
+    if (oldCount != this->rows.size())
+    {
+        Q_EMIT countChanged();
+    }
+}
+
+QStringList CompletionListModel::makeKeys(const QList<QVariantMap>& rows)
+{
+    QStringList keys;
+    keys.reserve(rows.size());
+
+    QHash<QString, int> occurrences;
+    for (const QVariantMap& row : rows)
+    {
+        const QString name = row.value("name").toString();
+        const int occurrence = occurrences[name]++;
+        keys.append(0 == occurrence ? name : name + "#" + QString::number(occurrence));
+    }
+    return keys;
+}
+
+void CompletionListModel::updateRow(int row, const QVariantMap& entry)
+{
+    QList<int> changedRoles;
+
+    const QHash<int, QByteArray>& roles = completionRoleNames();
+    for (auto it = roles.cbegin(); it != roles.cend(); ++it)
+    {
+        const QString key = QString::fromLatin1(it.value());
+        if (this->rows[row].value(key) != entry.value(key))
+        {
+            changedRoles.append(it.key());
+        }
+    }
+
+    if (true == changedRoles.isEmpty())
+    {
+        return;
+    }
+
+    this->rows[row] = entry;
+
+    const QModelIndex modelIndex = this->index(row);
+    Q_EMIT dataChanged(modelIndex, modelIndex, changedRoles);
+}
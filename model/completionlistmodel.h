@@ -0,0 +1,59 @@
+#ifndef COMPLETIONLISTMODEL_H
+#define COMPLETIONLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QVariantMap>
+
+// The rows of the intellisense menu: methods, constants or matched variables. A new result is not reset into the model, it is
+// diffed against the shown rows by name: rows, which are gone, are removed, new ones inserted, moved ones moved and only the
+// changed roles of the remaining rows are reported. So narrowing 300 methods by one typed character removes the few rows,
+// which do not match anymore, and the delegates of the others stay.
+// Must be used on the gui thread only.
+class CompletionListModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    Q_PROPERTY(int count READ getCount NOTIFY countChanged FINAL)
+public:
+    enum Roles
+    {
+        NameRole = Qt::UserRole + 1,
+        TypeRole,
+        DescriptionRole,
+        ArgsRole,
+        ReturnsRole,
+        ValueTypeRole,
+        ScopeRole,
+        StartIndexRole,
+        EndIndexRole,
+        MatchedPositionsRole
+    };
+public:
+    explicit CompletionListModel(QObject* parent = Q_NULLPTR);
+
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    virtual QHash<int, QByteArray> roleNames() const override;
+
+    int getCount(void) const;
+
+    // All fields of a row, e.g. for the key handling of the menu, empty if there is no such row
+    Q_INVOKABLE QVariantMap get(int row) const;
+
+    // Each entry is a QVariantMap with the role names as keys, the order is the new order of the rows
+    void setEntries(const QVariantList& entries);
+Q_SIGNALS:
+    void countChanged();
+private:
+    // The name, which identifies a row between two results, repeated names are numbered
+    static QStringList makeKeys(const QList<QVariantMap>& rows);
+
+    void updateRow(int row, const QVariantMap& entry);
+private:
+    QList<QVariantMap> rows;
+    QStringList keys;
+};
+
+#endif // COMPLETIONLISTMODEL_H
@@ -187,6 +187,18 @@ void LuaEditorModel::requestSaveLuaScript(void)
     }
 }
 
+void LuaEditorModel::requestSaveAllLuaScripts(void)
+{
+    // The saves of all scripts run in parallel in the background
+    for (LuaEditorModelItem* luaEditorModelItem : this->luaScripts)
+    {
+        if (Q_NULLPTR != luaEditorModelItem && true == luaEditorModelItem->getHasChanges())
+        {
+            Q_EMIT signal_requestSaveLuaScript(luaEditorModelItem->getFilePathName(), luaEditorModelItem->getContent());
+        }
+    }
+}
+
 void LuaEditorModel::addRecentFile(const QString& filePathName)
 {
     if (true == this->recentFiles.contains(filePathName))
@@ -414,6 +426,15 @@ void LuaEditorModel::sendVariableTextToEditor(const QString &text)
     }
 }
 
+void LuaEditorModel::insertTextAtCursor(const QString& text)
+{
+    const auto& luaEditorModelItem = this->getEditorModelItem(this->currentIndex);
+    if (Q_NULLPTR != luaEditorModelItem)
+    {
+        luaEditorModelItem->signal_insertTextAtCursor(text);
+    }
+}
+
 void LuaEditorModel::setSelectedSearchText(const QString& searchText)
 {
     Q_EMIT signal_setSelectedSearchText(searchText);
@@ -434,17 +455,20 @@ void LuaEditorModel::updateTitle(int row, const QString& newTitle)
     Q_EMIT dataChanged(index, index, { TitleRole });
 }
 
-void LuaEditorModel::luaScriptSaved()
+void LuaEditorModel::luaScriptSaved(const QString& filePathName, const QString& content)
 {
-    if (-1 == this->currentIndex)
+    // Saving runs in the background, the saved script is not necessarily the current one anymore
+    for (LuaEditorModelItem* luaEditorModelItem : this->luaScripts)
     {
-        qDebug() << "Error: Could not save file because there is no lua script.";
+        if (Q_NULLPTR != luaEditorModelItem && filePathName == luaEditorModelItem->getFilePathName())
+        {
+            if (content == luaEditorModelItem->getContent())
+            {
+                luaEditorModelItem->restoreContent();
+            }
+            return;
+        }
     }
 
-    LuaEditorModelItem* luaEditorModelItem = this->luaScripts.at(this->currentIndex);
-
-    if (Q_NULLPTR != luaEditorModelItem)
-    {
-        luaEditorModelItem->restoreContent();
-    }
+    qDebug() << "Error: Saved lua script is not open anymore: " << filePathName;
 }
@@ -17,6 +17,8 @@ public:
 
     Q_INVOKABLE void requestSaveLuaScript(void);
 
+    Q_INVOKABLE void requestSaveAllLuaScripts(void);
+
     Q_INVOKABLE void addRecentFile(const QString& filePathName);
 
     Q_INVOKABLE int count(void);
@@ -51,6 +53,9 @@ public:
 
     Q_INVOKABLE void sendVariableTextToEditor(const QString& text);
 
+    // Inserts the text at the cursor as it is, unlike sendTextToEditor not depending on the intellisense state, e.g. for the symbol search
+    Q_INVOKABLE void insertTextAtCursor(const QString& text);
+
     Q_INVOKABLE void setSelectedSearchText(const QString& searchText);
 
 public:
@@ -83,7 +88,8 @@ public:
 
     void updateTitle(int row, const QString& newTitle);
 
-    void luaScriptSaved(void);
+    // Content is what has been written, the script keeps its changes, if it has been edited meanwhile
+    void luaScriptSaved(const QString& filePathName, const QString& content);
 public:
     /**
      * @brief instance is the getter used to receive the object of this singleton implementation.
@@ -145,6 +145,9 @@ QString LuaEditorModelItem::getFilePathName() const
 void LuaEditorModelItem::detectVariables(void)
 {
     this->variableMap.clear();
+
+    // Runs on the intellisense worker too, one api for all lines
+    this->apiSnapshot = ApiModel::instance()->getSnapshot();
     QStringList lines = this->content.split('\n');
 
     // First Pass: Detect all variables
@@ -280,7 +283,7 @@ void LuaEditorModelItem::detectSingletons(const QString& line, int lineNumber)
         QString className = match.captured(1); // Singleton class name
 
         // Check if it's a valid class name
-        if (ApiModel::instance()->isValidClassName(className))
+        if (this->apiSnapshot->isValidClassName(className))
         {
             // Add to the variable map if not already present
             if (!this->variableMap.contains(className))
@@ -380,46 +383,26 @@ void LuaEditorModelItem::handleMethodCallAssignment(const QString& statement, in
         // Check if the objectVar already exists in the variableMap
         if (this->variableMap.contains(objectVar) && !this->variableMap[objectVar].type.isEmpty())
         {
-            QString type = this->variableMap[objectVar].type;
-
-            // Set the selected class name in ApiModel for method lookup
-            ApiModel::instance()->setSelectedClassName(this->variableMap[objectVar].type);
-
-            // Fetch the methods for this class
-            QVariantList methods = ApiModel::instance()->getMethodsForSelectedClass();
+            // Find the method in the class and get its return type, without brackets
+            const ApiSnapshot::MethodRecord* methodRecord = this->apiSnapshot->findMethod(this->variableMap[objectVar].type, methodName);
 
-            // Find the method in the class's methods and get its return type
-            for (const QVariant& methodVariant : methods)
+            // Assign the return type to the leftVar
+            if (Q_NULLPTR != methodRecord && false == methodRecord->returnType.isEmpty())
             {
-                QVariantMap methodMap = methodVariant.toMap();
-                QString currentMethodName = methodMap["name"].toString();
-
-                if (currentMethodName == methodName)
-                {
-                    // Removes the brackets around the return type
-                    QString returnType = methodMap["returns"].toString().remove(QRegularExpression("[()]"));
-
-                    // Assign the return type to the leftVar
-                    if (!returnType.isEmpty())
-                    {
-                        this->variableMap[leftVar] = LuaVariableInfo{leftVar, returnType, lineNumber, this->variableMap[leftVar].scope};
-
-                        // Case:  local nodeGameObjects = AppStateManager:getGameObjectController()
-                        // objectVar = AppStateManager and chain type would be GameObjectController for this line
-                        if (true == this->variableMap.contains(objectVar))
-                        {
-                            VerticalChainTypeInfo verticalChainTypeInfo;
-                            verticalChainTypeInfo.line = lineNumber;
-                            HorizontalChainTypeInfo horizontalChainTypeInfo;
-                            horizontalChainTypeInfo.chainType = returnType;
-                            verticalChainTypeInfo.horizontalChainTypes.append(horizontalChainTypeInfo);
-                            this->variableMap[objectVar].verticalChainTypeList.append(verticalChainTypeInfo);
-                        }
+                const QString& returnType = methodRecord->returnType;
 
-                        break;
-                    }
+                this->variableMap[leftVar] = LuaVariableInfo{leftVar, returnType, lineNumber, this->variableMap[leftVar].scope};
 
-                    break;
+                // Case:  local nodeGameObjects = AppStateManager:getGameObjectController()
+                // objectVar = AppStateManager and chain type would be GameObjectController for this line
+                if (true == this->variableMap.contains(objectVar))
+                {
+                    VerticalChainTypeInfo verticalChainTypeInfo;
+                    verticalChainTypeInfo.line = lineNumber;
+                    HorizontalChainTypeInfo horizontalChainTypeInfo;
+                    horizontalChainTypeInfo.chainType = returnType;
+                    verticalChainTypeInfo.horizontalChainTypes.append(horizontalChainTypeInfo);
+                    this->variableMap[objectVar].verticalChainTypeList.append(verticalChainTypeInfo);
                 }
             }
         }
@@ -509,26 +492,14 @@ QString LuaEditorModelItem::resolveMethodChainType(const QString& objectVar)
         {
             QString methodName = part.left(part.size() - 2);  // Remove "()" from method name
 
-            // Get methods available for the current type
-            ApiModel::instance()->setSelectedClassName(currentType);
-            QVariantList methods = ApiModel::instance()->getMethodsForSelectedClass();
-
-            bool methodFound = false;
-            for (const QVariant& methodVariant : methods)
-            {
-                QVariantMap methodMap = methodVariant.toMap();
-                if (methodMap["name"].toString() == methodName)
-                {
-                    currentType = methodMap["returns"].toString().remove('(').remove(')');
-                    methodFound = true;
-                    break;
-                }
-            }
-
-            if (!methodFound)
+            // Look the method up in the current type, without touching the selection of the intellisense
+            const ApiSnapshot::MethodRecord* methodRecord = this->apiSnapshot->findMethod(currentType, methodName);
+            if (Q_NULLPTR == methodRecord)
             {
                 return "";  // If method not found, stop processing
             }
+
+            currentType = methodRecord->returnType;
         }
         else
         {
@@ -615,8 +586,8 @@ void LuaEditorModelItem::handleMethodChain(const QString& statement, int lineNum
                 }
 
                 // Use ApiModel to get method details
-                QVariantMap methodDetails = ApiModel::instance()->getMethodDetails(currentType, methodCall);
-                if (methodDetails.isEmpty())
+                const ApiSnapshot::MethodRecord* methodRecord = this->apiSnapshot->findMethod(currentType, methodCall);
+                if (Q_NULLPTR == methodRecord)
                 {
                     if (true == this->printToConsole)
                     {
@@ -625,7 +596,7 @@ void LuaEditorModelItem::handleMethodChain(const QString& statement, int lineNum
                     continue;
                 }
 
-                QString tempType = methodDetails["returns"].toString();
+                QString tempType = methodRecord->returns;
 
                 // Get the return type for the next step
                 currentType = tempType;
@@ -976,22 +947,22 @@ QVariantMap LuaEditorModelItem::processMatchedVariables(bool forSingleton, const
     }
     else
     {
-        const auto& apiData = ApiModel::instance()->getApiData();
+        const std::shared_ptr<const ApiSnapshot> apiSnapshot = ApiModel::instance()->getSnapshot();
 
-        for (auto it = apiData.cbegin(); it != apiData.cend(); ++it)
+        for (int i = 0; i < apiSnapshot->getClassCount(); ++i)
         {
-            const LuaScriptAdapter::ClassData& classData = it.value();
+            const ApiSnapshot::ClassRecord& classRecord = apiSnapshot->getClassAt(i);
 
             // Check all singletons from the lua api directly
-            if ("singleton" == classData.type)
+            if ("singleton" == classRecord.type)
             {
-                QString name = it.key();
+                QString name = classRecord.name;
                 if (name.contains(text, Qt::CaseSensitive))
                 {
                     // Create match details
                     QVariantMap matchDetails;
                     matchDetails["name"] = name;
-                    matchDetails["type"] = it.value().type;
+                    matchDetails["type"] = classRecord.type;
                     matchDetails["scope"] = "singleton";
 
                     // Find the start and end indices of the match
@@ -5,8 +5,12 @@
 #include <QMap>
 #include <QThread>
 
+#include <memory>
+
 #include "matchclassworker.h"
 
+class ApiSnapshot;
+
 class LuaEditorModelItem : public QObject
 {
     Q_OBJECT
@@ -116,6 +120,8 @@ Q_SIGNALS:
     void signal_sendTextToEditor(const QString& text);
 
     void signal_sendVariableTextToEditor(const QString& text);
+
+    void signal_insertTextAtCursor(const QString& text);
 private:
     void detectLocalVariables(const QString& line, int lineNumber);
 
@@ -154,6 +160,7 @@ private:
     bool hasChanges;
     bool firstTimeContent;
     QMap<QString, LuaVariableInfo> variableMap;
+    std::shared_ptr<const ApiSnapshot> apiSnapshot; // Of the last detectVariables
 
     MatchClassWorker* matchClassWorker;
     QThread* matchClassThread;
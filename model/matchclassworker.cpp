@@ -46,6 +46,9 @@ void MatchClassWorker::process(void)
     this->isProcessing = true;
     this->isStopped = false; // Reset the stop flag
 
+    // One api for the whole pass, a reload meanwhile does not change it under the worker
+    this->apiSnapshot = ApiModel::instance()->getSnapshot();
+
     // Set the content for processing
     this->luaEditorModelItem->setContent(this->currentText);
 
@@ -56,7 +59,11 @@ void MatchClassWorker::process(void)
 
     if (this->matchedClassName != oldMatchedClassName)
     {
-        ApiModel::instance()->setSelectedClassName(this->matchedClassName);
+        // The selection is gui state
+        QMetaObject::invokeMethod(ApiModel::instance(), [matchedClassName = this->matchedClassName]()
+                                  {
+                                      ApiModel::instance()->setSelectedClassName(matchedClassName);
+                                  });
     }
 
     QString variableTyped;
@@ -171,11 +178,7 @@ void MatchClassWorker::process(void)
         {
             if (false == this->matchedClassName.isEmpty())
             {
-                ApiModel::instance()->processMatchedMethodsForSelectedClass(this->matchedClassName, cleanTypedAfterKeyword);
-                if (false == ApiModel::instance()->getSelectedClassName().isEmpty())
-                {
-                    ApiModel::instance()->showIntelliSenseMenu("forClass", this->matchedClassName, mouseX, mouseY);
-                }
+                ApiModel::instance()->showMatchedMethodsForClass(*this->apiSnapshot, this->matchedClassName, cleanTypedAfterKeyword, mouseX, mouseY);
             }
             else
             {
@@ -187,8 +190,7 @@ void MatchClassWorker::process(void)
         {
             if (false == this->matchedClassName.isEmpty())
             {
-                ApiModel::instance()->processMatchedConstantsForSelectedClass(this->matchedClassName, cleanTypedAfterKeyword);
-                ApiModel::instance()->showIntelliSenseMenu("forConstant", this->matchedClassName, mouseX, mouseY);
+                ApiModel::instance()->showMatchedConstantsForClass(*this->apiSnapshot, this->matchedClassName, cleanTypedAfterKeyword, mouseX, mouseY);
             }
             else
             {
@@ -612,9 +614,7 @@ QString MatchClassWorker::handleCurrentLine(const QString& segment, bool& handle
             {
                 // Case e.g. inside function parameters: physicsActiveComponent:setDirection(Vector3.
                 // Segment: Vector3, delimeter = ".", check constant
-                const auto& constants = ApiModel::instance()->getConstantsForClassName(token);
-
-                if (false == constants.isEmpty())
+                if (true == this->apiSnapshot->hasConstants(token))
                 {
                     rootClassName = token;
                     this->matchedClassName = rootClassName;
@@ -625,20 +625,13 @@ QString MatchClassWorker::handleCurrentLine(const QString& segment, bool& handle
                 {
                     // Case e.g. inside function parameters: physicsActiveComponent:setDirection(physicsActiveComponent:getDirection() +...
                     // Segment: Vector3, delimeter = ":", check methods
-                    const auto& methods = ApiModel::instance()->getMethodsForClassName(rootClassName);
-
-                    if (false == methods.isEmpty())
+                    if (true == this->apiSnapshot->hasMethods(rootClassName))
                     {
-                        for (const QVariant& methodVariant : methods)
+                        if (Q_NULLPTR != this->apiSnapshot->findMethod(rootClassName, token))
                         {
-                            QVariantMap methodMap = methodVariant.toMap();
-                            if (methodMap["name"].toString() == token)
-                            {
-                                this->matchedMethodName = token;
-                                rootClassName = this->matchedClassName;
-                                isMatched = true;
-                                break;
-                            }
+                            this->matchedMethodName = token;
+                            rootClassName = this->matchedClassName;
+                            isMatched = true;
                         }
                     }
                     else
@@ -667,76 +660,71 @@ QString MatchClassWorker::handleCurrentLine(const QString& segment, bool& handle
                 this->forVariable = false;
                 this->forConstant = false;
                 isMatched = false;
-                const auto& methods = ApiModel::instance()->getMethodsForClassName(rootClassName);
+                const ApiSnapshot::MethodRecord* methodRecord = this->apiSnapshot->findMethod(rootClassName, token);
 
-                for (const QVariant& methodVariant : methods)
+                if (Q_NULLPTR != methodRecord)
                 {
-                    QVariantMap methodMap = methodVariant.toMap();
-                    if (methodMap["name"].toString() == token)
-                    {
-                        this->matchedMethodName = token;
-                        QString args = methodMap["args"].toString();
+                    this->matchedMethodName = token;
+                    const QString& args = methodRecord->args;
 
-                        if (true == this->forFunctionParameters)
-                        {
-                            if (/*rootClassName == this->matchedClassName &&*/ "()" == args)
-                            {
-                                QString valueType = methodMap["valuetype"].toString();
-                                if (false == this->isLuaNativeType(valueType))
-                                {
-                                    this->matchedClassName = valueType;
-                                    rootClassName = this->matchedClassName;
-                                }
-                            }
-                        }
-                        else
+                    if (true == this->forFunctionParameters)
+                    {
+                        if (/*rootClassName == this->matchedClassName &&*/ "()" == args)
                         {
-                            QString valueType = methodMap["valuetype"].toString();
+                            const QString& valueType = methodRecord->valuetype;
                             if (false == this->isLuaNativeType(valueType))
                             {
                                 this->matchedClassName = valueType;
                                 rootClassName = this->matchedClassName;
                             }
-                            else
-                            {
-                                rootClassName = this->matchedClassName;
-                            }
                         }
-
-#if 0
-                        if (rootClassName != this->matchedClassName)
+                    }
+                    else
+                    {
+                        const QString& valueType = methodRecord->valuetype;
+                        if (false == this->isLuaNativeType(valueType))
                         {
+                            this->matchedClassName = valueType;
                             rootClassName = this->matchedClassName;
                         }
-
                         else
                         {
-                            // Does not work for this case:
-                            //gameObjectTitleComponent:getOffsetOrientation():angleBetween(
-                            // getOffsetOrientation = Vector3 class
-                            //     angleBetween = Radian
-                            //
-                            //            Problem:
-                            //                      methodName: angleBetween
-                            //                      className must be: Vector3, instead Radian, which comes from valuetype
-                            // QString valueType = methodMap["valuetype"].toString();
-                            // if (false == this->isLuaNativeType(valueType))
-                            // {
-                            //     this->matchedClassName = methodMap["valuetype"].toString();
-                            // }
-                            QString valueType = methodMap["valuetype"].toString();
-                            if (false == this->isLuaNativeType(valueType))
-                            {
-                                this->matchedClassName = methodMap["valuetype"].toString();
-                                rootClassName = this->matchedClassName;
-                            }
+                            rootClassName = this->matchedClassName;
                         }
-#endif
+                    }
 
-                        this->forConstant = false;
-                        isMatched = true;
-                        break;
+#if 0
+                    if (rootClassName != this->matchedClassName)
+                    {
+                        rootClassName = this->matchedClassName;
                     }
+
+                    else
+                    {
+                        // Does not work for this case:
+                        //gameObjectTitleComponent:getOffsetOrientation():angleBetween(
+                        // getOffsetOrientation = Vector3 class
+                        //     angleBetween = Radian
+                        //
+                        //            Problem:
+                        //                      methodName: angleBetween
+                        //                      className must be: Vector3, instead Radian, which comes from valuetype
+                        // const QString& valueType = methodRecord->valuetype;
+                        // if (false == this->isLuaNativeType(valueType))
+                        // {
+                        //     this->matchedClassName = methodRecord->valuetype;
+                        // }
+                        const QString& valueType = methodRecord->valuetype;
+                        if (false == this->isLuaNativeType(valueType))
+                        {
+                            this->matchedClassName = methodRecord->valuetype;
+                            rootClassName = this->matchedClassName;
+                        }
+                    }
+#endif
+
+                    this->forConstant = false;
+                    isMatched = true;
                 }
 
                 if (false == isMatched)
@@ -750,18 +738,11 @@ QString MatchClassWorker::handleCurrentLine(const QString& segment, bool& handle
                 this->forVariable = false;
                 this->forConstant = true;
 
-                const auto& constants = ApiModel::instance()->getConstantsForClassName(rootClassName);
-
-                for (const QVariant& constantVariant : constants)
+                if (Q_NULLPTR != this->apiSnapshot->findConstant(rootClassName, token))
                 {
-                    QVariantMap constantMap = constantVariant.toMap();
-                    if (constantMap["name"].toString() == token)
-                    {
-                        this->matchedMethodName = token;
-                        this->forConstant = true;
-                        isMatched = true;
-                        break;
-                    }
+                    this->matchedMethodName = token;
+                    this->forConstant = true;
+                    isMatched = true;
                 }
             }
             else if (token.startsWith("\"") || token.startsWith("'")) // Handle strings
@@ -951,8 +932,8 @@ bool MatchClassWorker::handleInsideFunctionParameters(void)
         return false;
     }
 
-    // Get the method details from ApiModel
-    const auto& methodDetails = ApiModel::instance()->getMethodDetails(this->matchedClassName, this->matchedMethodName);
+    // Get the method details from the api of this pass
+    const auto& methodDetails = this->apiSnapshot->getMethodDetails(this->matchedClassName, this->matchedMethodName);
 
     if (true == methodDetails.isEmpty())
     {
@@ -3,7 +3,10 @@
 
 #include <QObject>
 
+#include <memory>
+
 class LuaEditorModelItem;
+class ApiSnapshot;
 
 class MatchClassWorker : public QObject
 {
@@ -40,6 +43,7 @@ private:
     bool handleInsideFunctionParameters(void);
 private:
     LuaEditorModelItem* luaEditorModelItem;
+    std::shared_ptr<const ApiSnapshot> apiSnapshot; // Of the current pass
     QString currentText;
     QString typedAfterKeyword;
     int cursorPosition;
@@ -0,0 +1,193 @@
+#include "symbolindex.h"
+
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+
+void SymbolIndex::build(const QStringList& names)
+{
+    this->terms.clear();
+    this->symbolBegins.clear();
+    this->symbols.clear();
+    this->trigramTerms.clear();
+
+    QStringList foldedNames;
+    foldedNames.reserve(names.size());
+    for (const QString& name : names)
+    {
+        foldedNames.append(name.toLower());
+    }
+
+    // Symbols sorted by their lower case name, equal names become one term
+    QList<int> order(names.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&foldedNames](int left, int right)
+                     {
+                         return foldedNames[left] < foldedNames[right];
+                     });
+
+    this->symbols.reserve(names.size());
+    for (const int symbol : order)
+    {
+        if (true == this->terms.isEmpty() || this->terms.last() != foldedNames[symbol])
+        {
+            this->terms.append(foldedNames[symbol]);
+            this->symbolBegins.append(static_cast<int>(this->symbols.size()));
+        }
+        this->symbols.append(symbol);
+    }
+    this->symbolBegins.append(static_cast<int>(this->symbols.size()));
+
+    // Terms are visited in ascending order, so each trigram list stays sorted
+    for (int termId = 0; termId < this->terms.size(); ++termId)
+    {
+        const QString& term = this->terms[termId];
+        for (int position = 0; position + 3 <= term.size(); ++position)
+        {
+            QList<int>& termIds = this->trigramTerms[trigram(term, position)];
+            if (true == termIds.isEmpty() || termIds.last() != termId)
+            {
+                termIds.append(termId);
+            }
+        }
+    }
+
+    for (auto it = this->trigramTerms.begin(); it != this->trigramTerms.end(); ++it)
+    {
+        it.value().squeeze();
+    }
+}
+
+QList<int> SymbolIndex::find(const QString& text, int maxResults) const
+{
+    QList<int> result;
+    if (true == text.isEmpty() || true == this->terms.isEmpty())
+    {
+        return result;
+    }
+
+    const QString folded = text.toLower();
+    QList<int> termIds;
+
+    if (folded.size() < 3)
+    {
+        // Too short for a trigram, the terms with this prefix are a range of the sorted terms
+        auto it = std::lower_bound(this->terms.cbegin(), this->terms.cend(), folded);
+        for (; it != this->terms.cend() && true == it->startsWith(folded); ++it)
+        {
+            termIds.append(static_cast<int>(it - this->terms.cbegin()));
+        }
+    }
+    else
+    {
+        QList<const QList<int>*> trigramLists;
+        for (int position = 0; position + 3 <= folded.size(); ++position)
+        {
+            auto it = this->trigramTerms.constFind(trigram(folded, position));
+            if (this->trigramTerms.constEnd() == it)
+            {
+                // No term has these three characters
+                return result;
+            }
+            trigramLists.append(&it.value());
+        }
+
+        // Rarest first, the candidates shrink fastest
+        std::sort(trigramLists.begin(), trigramLists.end(), [](const QList<int>* left, const QList<int>* right)
+                  {
+                      return left->size() < right->size();
+                  });
+
+        QList<int> candidates = *trigramLists.first();
+        for (int i = 1; i < trigramLists.size() && false == candidates.isEmpty(); ++i)
+        {
+            candidates = intersect(candidates, *trigramLists[i]);
+        }
+
+        // All trigrams do not mean the whole text, e.g. "getxetpos" has those of "getpos" too
+        for (const int termId : candidates)
+        {
+            if (true == this->terms[termId].contains(folded))
+            {
+                termIds.append(termId);
+            }
+        }
+    }
+
+    // Term ids are sorted by name already, only the kind of match orders before
+    auto rank = [this, &folded](int termId)
+    {
+        const QString& term = this->terms[termId];
+        if (term.size() == folded.size())
+        {
+            return 0;
+        }
+        return true == term.startsWith(folded) ? 1 : 2;
+    };
+
+    std::stable_sort(termIds.begin(), termIds.end(), [&rank](int left, int right)
+                     {
+                         return rank(left) < rank(right);
+                     });
+
+    for (const int termId : termIds)
+    {
+        this->appendSymbols(termId, result, maxResults);
+        if (maxResults > 0 && result.size() >= maxResults)
+        {
+            break;
+        }
+    }
+    return result;
+}
+
+int SymbolIndex::getTermCount(void) const
+{
+    return static_cast<int>(this->terms.size());
+}
+
+qint64 SymbolIndex::getMemoryBytes(void) const
+{
+    qint64 bytes = this->terms.capacity() * static_cast<qint64>(sizeof(QString));
+    for (const QString& term : this->terms)
+    {
+        bytes += 16 + term.capacity() * static_cast<qint64>(sizeof(QChar));
+    }
+
+    bytes += (this->symbolBegins.capacity() + this->symbols.capacity()) * static_cast<qint64>(sizeof(int));
+
+    bytes += this->trigramTerms.capacity() * static_cast<qint64>(sizeof(quint64) + sizeof(QList<int>) + 1);
+    for (auto it = this->trigramTerms.cbegin(); it != this->trigramTerms.cend(); ++it)
+    {
+        bytes += 16 + it.value().capacity() * static_cast<qint64>(sizeof(int));
+    }
+    return bytes;
+}
+
+quint64 SymbolIndex::trigram(const QString& folded, int position)
+{
+    return static_cast<quint64>(folded[position].unicode()) << 32
+           | static_cast<quint64>(folded[position + 1].unicode()) << 16
+           | static_cast<quint64>(folded[position + 2].unicode());
+}
+
+QList<int> SymbolIndex::intersect(const QList<int>& left, const QList<int>& right)
+{
+    QList<int> result;
+    result.reserve(qMin(left.size(), right.size()));
+
+    std::set_intersection(left.cbegin(), left.cend(), right.cbegin(), right.cend(), std::back_inserter(result));
+    return result;
+}
+
+void SymbolIndex::appendSymbols(int termId, QList<int>& result, int maxResults) const
+{
+    for (int i = this->symbolBegins[termId]; i < this->symbolBegins[termId + 1]; ++i)
+    {
+        if (maxResults > 0 && result.size() >= maxResults)
+        {
+            return;
+        }
+        result.append(this->symbols[i]);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef SYMBOLINDEX_H
+#define SYMBOLINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+
+// Inverted index over the method and constant names of all api classes, so that a symbol is found without knowing its class.
+// Each distinct lower case name is a term, which lists the symbols with that name, e.g. getPosition of hundreds of classes.
+// Every three characters of a term (trigram) list the terms containing them. A search intersects the lists of the trigrams of
+// the text and only checks the few terms left, instead of scanning all names. Texts shorter than a trigram match term prefixes.
+// Built once, when the api is set, afterwards only read.
+class SymbolIndex
+{
+public:
+    // names[i] is the name of symbol i, e.g. the method record i of the ApiModel
+    void build(const QStringList& names);
+
+    // Symbols, whose name contains the text, case insensitive. Exact names first, then prefixes, then the rest, each by name.
+    QList<int> find(const QString& text, int maxResults = 200) const;
+
+    int getTermCount(void) const;
+
+    // Estimated heap bytes of the terms, their symbol lists and the trigram lists
+    qint64 getMemoryBytes(void) const;
+private:
+    static quint64 trigram(const QString& folded, int position);
+
+    // Ascending term ids of both lists
+    static QList<int> intersect(const QList<int>& left, const QList<int>& right);
+
+    void appendSymbols(int termId, QList<int>& result, int maxResults) const;
+private:
+    QStringList terms; // Sorted lower case names
+    QList<int> symbolBegins; // The symbols of term i are [symbolBegins[i], symbolBegins[i + 1]) of symbols
+    QList<int> symbols;
+    QHash<quint64, QList<int>> trigramTerms; // Ascending term ids
+};
+
+#endif // SYMBOLINDEX_H
@@ -0,0 +1,133 @@
+#include "symbolsearchmodel.h"
+#include "apimodel.h"
+
+#include <QElapsedTimer>
+
+namespace
+{
+    // Rows a person scrolls through, the query is made more specific instead
+    const int maxSymbolResults = 500;
+}
+
+SymbolSearchModel* SymbolSearchModel::ms_pInstance = Q_NULLPTR;
+QMutex SymbolSearchModel::ms_mutex;
+
+SymbolSearchModel::SymbolSearchModel(QObject* parent)
+    : QAbstractListModel{parent},
+    searchMicroseconds(0.0)
+{
+    // A reload of the api swaps the snapshot, search the new one
+    connect(ApiModel::instance(), &ApiModel::modelReset, this, &SymbolSearchModel::search);
+}
+
+SymbolSearchModel* SymbolSearchModel::instance()
+{
+    QMutexLocker lock(&ms_mutex);
+
+    if (ms_pInstance == Q_NULLPTR)
+    {
+        ms_pInstance = new SymbolSearchModel();
+    }
+    return ms_pInstance;
+}
+
+QObject* SymbolSearchModel::getSingletonTypeProvider(QQmlEngine* pEngine, QJSEngine* pScriptEngine)
+{
+    Q_UNUSED(pEngine)
+    Q_UNUSED(pScriptEngine)
+
+    return instance();
+}
+
+int SymbolSearchModel::rowCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return static_cast<int>(this->methodIndices.size());
+}
+
+QVariant SymbolSearchModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= this->methodIndices.size())
+    {
+        return QVariant();
+    }
+
+    const ApiSnapshot::MethodRecord& methodRecord = this->apiSnapshot->getMethodAt(this->methodIndices.at(index.row()));
+
+    switch (role)
+    {
+    case SymbolNameRole:
+        return methodRecord.name;
+    case ClassNameRole:
+        return this->apiSnapshot->getClassAt(methodRecord.classIndex).name;
+    case KindRole:
+        return QString(true == methodRecord.isConstant ? "constant" : "method");
+    case ArgsRole:
+        return methodRecord.args;
+    case ReturnsRole:
+        return methodRecord.returns;
+    case DescriptionRole:
+        return methodRecord.description;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> SymbolSearchModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[SymbolNameRole] = "symbolName";
+    roles[ClassNameRole] = "className";
+    roles[KindRole] = "kind";
+    roles[ArgsRole] = "args";
+    roles[ReturnsRole] = "returns";
+    roles[DescriptionRole] = "description";
+    return roles;
+}
+
+QString SymbolSearchModel::getQuery(void) const
+{
+    return this->query;
+}
+
+void SymbolSearchModel::setQuery(const QString& query)
+{
+    if (this->query == query)
+    {
+        return;
+    }
+
+    this->query = query;
+    Q_EMIT queryChanged();
+
+    this->search();
+}
+
+int SymbolSearchModel::getCount(void) const
+{
+    return static_cast<int>(this->methodIndices.size());
+}
+
+double SymbolSearchModel::getSearchMicroseconds(void) const
+{
+    return this->searchMicroseconds;
+}
+
+void SymbolSearchModel::search(void)
+{
+    const std::shared_ptr<const ApiSnapshot> apiSnapshot = ApiModel::instance()->getSnapshot();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<int> methodIndices = apiSnapshot->findSymbols(this->query, maxSymbolResults);
+
+    this->searchMicroseconds = timer.nsecsElapsed() / 1000.0;
+
+    beginResetModel();
+    this->apiSnapshot = apiSnapshot;
+    this->methodIndices = methodIndices;
+    endResetModel();
+
+    Q_EMIT countChanged();
+}
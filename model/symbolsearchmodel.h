@@ -0,0 +1,80 @@
+#ifndef SYMBOLSEARCHMODEL_H
+#define SYMBOLSEARCHMODEL_H
+
+#include <QAbstractListModel>
+#include <QQmlEngine>
+#include <QMutex>
+
+#include <memory>
+
+class ApiSnapshot;
+
+// The methods and constants of all api classes, whose name contains the query, e.g. which classes have "getPosition".
+// Searches the SymbolIndex of the ApiModel on every change of the query and again, when the api is reloaded.
+class SymbolSearchModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    Q_PROPERTY(QString query READ getQuery WRITE setQuery NOTIFY queryChanged FINAL)
+
+    Q_PROPERTY(int count READ getCount NOTIFY countChanged FINAL)
+
+    Q_PROPERTY(double searchMicroseconds READ getSearchMicroseconds NOTIFY countChanged FINAL)
+public:
+    explicit SymbolSearchModel(QObject* parent = Q_NULLPTR);
+
+public:
+    /**
+     * @brief instance is the getter used to receive the object of this singleton implementation.
+     * @returns singleton instance of this
+     */
+    static SymbolSearchModel* instance();
+
+    /**
+     * @brief The singleton type provider is needed by the Qt(-meta)-system to register this singleton instace in qml world
+     * @param pEngine not used but needed by function base
+     * @param pSriptEngine not used but needed by function base
+     * @returns singleton instance of this
+     */
+    static QObject* getSingletonTypeProvider(QQmlEngine* pEngine, QJSEngine* pScriptEngine);
+public:
+    enum Roles
+    {
+        SymbolNameRole = Qt::UserRole + 1,
+        ClassNameRole,
+        KindRole,
+        ArgsRole,
+        ReturnsRole,
+        DescriptionRole
+    };
+
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    virtual QHash<int, QByteArray> roleNames() const override;
+
+    QString getQuery(void) const;
+
+    void setQuery(const QString& query);
+
+    int getCount(void) const;
+
+    double getSearchMicroseconds(void) const;
+Q_SIGNALS:
+    void queryChanged();
+
+    void countChanged();
+private:
+    void search(void);
+private:
+    static SymbolSearchModel* ms_pInstance;
+    static QMutex ms_mutex;
+
+    QString query;
+    std::shared_ptr<const ApiSnapshot> apiSnapshot; // The one searched, the indices belong to it
+    QList<int> methodIndices; // Of the method records of the snapshot
+    double searchMicroseconds;
+};
+
+#endif // SYMBOLSEARCHMODEL_H
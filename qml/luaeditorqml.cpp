@@ -3,6 +3,7 @@
 #include "model/luaeditormodelitem.h"
 
 #include "luascriptqmladapter.h"
+#include "backend/latencyprobe.h"
 
 #include <QTextDocument>
 #include <QFontMetrics>
@@ -162,6 +163,17 @@ void LuaEditorQml::setModel(LuaEditorModelItem* luaEditorModelItem)
         this->oldCursorPosition = this->cursorPosition - 1;
     });
 
+    connect(this->luaEditorModelItem, &LuaEditorModelItem::signal_insertTextAtCursor, this, [this](const QString& text) {
+        this->luaEditorTextEdit->forceActiveFocus();
+        // Nothing is replaced, the text goes where the cursor is
+        this->highlighter->insertSentText(0, text);
+        this->resetTextAfterColon();
+        this->resetTextAfterDot();
+        Q_EMIT requestCloseIntellisense();
+
+        this->oldCursorPosition = this->cursorPosition - 1;
+    });
+
     connect(this, &LuaEditorQml::requestIntellisenseProcessing, this->luaEditorModelItem, &LuaEditorModelItem::startIntellisenseProcessing);
     connect(this, &LuaEditorQml::requestCloseIntellisense, this->luaEditorModelItem, &LuaEditorModelItem::closeIntellisense);
 
@@ -876,6 +888,12 @@ void LuaEditorQml::highlightRuntimeError(int line, int start, int end)
 {
     if (Q_NULLPTR != this->highlighter)
     {
+#ifdef NOWA_LATENCY_PROBE
+        if (Q_NULLPTR != this->model())
+        {
+            LatencyProbe::instance()->reportHighlighted(this->model()->getFilePathName(), line);
+        }
+#endif
         this->highlighter->setRuntimeErrorLine(line, start, end);
     }
 }
@@ -888,6 +906,28 @@ void LuaEditorQml::clearRuntimeError()
     }
 }
 
+void LuaEditorQml::highlightRuntimeErrorFrames(const QVariantList& frames)
+{
+    if (Q_NULLPTR == this->highlighter)
+    {
+        return;
+    }
+
+    QMap<int, QPair<int, int>> frameRanges;
+
+    for (int i = 1; i < frames.size(); ++i)
+    {
+        const QVariantMap frame = frames[i].toMap();
+
+        if (true == frame["inDocument"].toBool())
+        {
+            frameRanges.insert(frame["line"].toInt(), qMakePair(frame["start"].toInt(), frame["end"].toInt()));
+        }
+    }
+
+    this->highlighter->setRuntimeErrorFrames(frameRanges);
+}
+
 void LuaEditorQml::cursorPositionChanged(int cursorPosition)
 {
     if (this->cursorPosition == cursorPosition)
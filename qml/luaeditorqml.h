@@ -27,6 +27,9 @@ public:
 
      Q_INVOKABLE void clearRuntimeError();
 
+     // Marks every frame of a runtime error, which is in this script, except the first one, which highlightRuntimeError marks
+     Q_INVOKABLE void highlightRuntimeErrorFrames(const QVariantList& frames);
+
      Q_INVOKABLE void cursorPositionChanged(int cursorPosition);
 
      Q_INVOKABLE void handleKeywordPressed(QChar keyword);
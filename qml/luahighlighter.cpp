@@ -8,11 +8,6 @@
 LuaHighlighter::LuaHighlighter(QQuickItem* luaEditorTextEdit, QObject* parent)
     : QSyntaxHighlighter{parent},
     luaEditorTextEdit(luaEditorTextEdit),
-    errorLine(-1),
-    oldErrorLine(-2),
-    errorStart(-1),
-    errorEnd(-1),
-    errorAlreadyCleared(true),
     runtimeErrorLine(-1),
     oldRuntimeErrorLine(-2),
     runtimeErrorStart(-1),
@@ -34,6 +29,11 @@ LuaHighlighter::LuaHighlighter(QQuickItem* luaEditorTextEdit, QObject* parent)
     this->runtimeErrorFormat.setForeground(Qt::darkMagenta); // Set error color to red
     this->runtimeErrorFormat.setFontUnderline(true); // Underline the text
 
+    // The calls, which led to the runtime error
+    this->runtimeFrameFormat.setForeground(Qt::darkMagenta);
+    this->runtimeFrameFormat.setFontUnderline(true);
+    this->runtimeFrameFormat.setUnderlineStyle(QTextCharFormat::DotLine);
+
     HighlightingRule rule;
 
     // Define keyword formats
@@ -64,38 +64,30 @@ LuaHighlighter::LuaHighlighter(QQuickItem* luaEditorTextEdit, QObject* parent)
 
 void LuaHighlighter::setErrorLine(int line, int start, int end)
 {
-    if (this->errorLine == line && this->errorStart == start && this->errorEnd == end)
+    auto it = this->errorRanges.constFind(line);
+    if (this->errorRanges.constEnd() != it && it.value() == qMakePair(start, end))
     {
         return;  // Same error, no need to rehighlight
     }
-    this->errorLine  = line;
-    this->errorStart = start;
-    this->errorEnd   = end;
-    this->rehighlight();
+
+    // Several errors may be shown at once, only the block of this one needs to be highlighted again
+    this->errorRanges.insert(line, qMakePair(start, end));
+    this->rehighlightBlock(document()->findBlockByNumber(line - 1));
 }
 
 void LuaHighlighter::clearErrors()
 {
-    if (false == this->errorAlreadyCleared)
+    if (true == this->errorRanges.isEmpty())
     {
-        // Clear highlight for the specific line
-        QTextCharFormat format; // Reset to default format
-        format.setBackground(Qt::transparent); // Set to transparent to clear highlight
-
-        QTextBlock block = document()->findBlockByLineNumber(this->errorLine);
-        if (block.isValid())
-        {
-            // Clear formatting for the entire block (line)
-            setFormat(block.firstLineNumber(), block.length(), format);
-        }
-
-        this->errorLine = -1;
-        this->errorStart = -1;
-        this->errorEnd = -1;
+        return;
+    }
 
-        this->rehighlight(); // Rehighlight the document to clear errors
+    const QList<int> lines = this->errorRanges.keys();
+    this->errorRanges.clear();
 
-        this->errorAlreadyCleared = true;
+    for (int line : lines)
+    {
+        this->rehighlightBlock(document()->findBlockByNumber(line - 1));
     }
 }
 
@@ -111,8 +103,29 @@ void LuaHighlighter::setRuntimeErrorLine(int line, int start, int end)
     }
 }
 
+void LuaHighlighter::setRuntimeErrorFrames(const QMap<int, QPair<int, int>>& frameRanges)
+{
+    if (this->runtimeFrameRanges == frameRanges)
+    {
+        return;
+    }
+
+    // Only the blocks of the old and the new frames need to be highlighted again
+    QList<int> lines = this->runtimeFrameRanges.keys();
+    lines.append(frameRanges.keys());
+
+    this->runtimeFrameRanges = frameRanges;
+
+    for (int line : lines)
+    {
+        this->rehighlightBlock(document()->findBlockByNumber(line - 1));
+    }
+}
+
 void LuaHighlighter::clearRuntimeErrors()
 {
+    this->setRuntimeErrorFrames(QMap<int, QPair<int, int>>());
+
     if (false == this->runtimeErrorAlreadyCleared)
     {
         // Clear highlight for the specific line
@@ -632,16 +645,19 @@ void LuaHighlighter::highlightBlock(const QString& text)
         }
     }
 
-    this->errorAlreadyCleared = false;
-
-    // Only apply error formatting if we are on the error line
-    if (this->errorLine != -1)
+    // Apply the error format, if there is an error on this line
+    auto errorIt = this->errorRanges.constFind(currentBlock().blockNumber() + 1);
+    if (this->errorRanges.constEnd() != errorIt)
     {
-        // Get the current block number to check if it matches errorLine
-        int currentBlockNumber = currentBlock().blockNumber();
+        const int start = errorIt.value().first;
+        const int end = errorIt.value().second;
 
-        // If current block number matches the error line, apply the error format
-        if (currentBlockNumber == this->errorLine - 1)
+        if (end > start && start < text.length())
+        {
+            // Only the offending token
+            setFormat(start, qMin(end, static_cast<int>(text.length())) - start, this->errorFormat);
+        }
+        else
         {
             // Format is per block! so the current block starts with 0, the next one too!
             // Set the format for the entire block (line)
@@ -651,6 +667,22 @@ void LuaHighlighter::highlightBlock(const QString& text)
 
     this->runtimeErrorAlreadyCleared = false;
 
+    auto frameIt = this->runtimeFrameRanges.constFind(currentBlock().blockNumber() + 1);
+    if (this->runtimeFrameRanges.constEnd() != frameIt)
+    {
+        const int start = frameIt.value().first;
+        const int end = frameIt.value().second;
+
+        if (end > start && start < text.length())
+        {
+            setFormat(start, qMin(end, static_cast<int>(text.length())) - start, this->runtimeFrameFormat);
+        }
+        else
+        {
+            setFormat(0, text.length(), this->runtimeFrameFormat);
+        }
+    }
+
     // Only apply runtime error formatting if we are on the error line
     if (this->runtimeErrorLine != -1)
     {
@@ -6,6 +6,7 @@
 #include <QRegularExpression>
 #include <QTextCharFormat>
 #include <QQuickItem>
+#include <QMap>
 
 class LuaHighlighter : public QSyntaxHighlighter
 {
@@ -23,6 +24,9 @@ public:
 
     void clearRuntimeErrors();
 
+    // Marks the calls of the outer frames of a runtime error, line -> start and end column, 0 and 0 for the whole line
+    void setRuntimeErrorFrames(const QMap<int, QPair<int, int>>& frameRanges);
+
     void commentSelection();
 
     void uncommentSelection();
@@ -76,18 +80,16 @@ private:
     QQuickItem* luaEditorTextEdit;
 
     QVector<HighlightingRule> highlightingRules;
-    int errorLine;
-    int oldErrorLine;
-    int errorStart;
-    int errorEnd;
+    QMap<int, QPair<int, int>> errorRanges; // Line -> start and end column of each syntax error
     QTextCharFormat errorFormat;
-    bool errorAlreadyCleared;
 
     int runtimeErrorLine;
     int oldRuntimeErrorLine;
     int runtimeErrorStart;
     int runtimeErrorEnd;
     QTextCharFormat runtimeErrorFormat;
+    QMap<int, QPair<int, int>> runtimeFrameRanges;
+    QTextCharFormat runtimeFrameFormat;
     bool runtimeErrorAlreadyCleared;
 
     QTextCursor cursor;
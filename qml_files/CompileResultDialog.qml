@@ -0,0 +1,105 @@
+import QtQuick 2.15
+import QtQuick.Controls 2.15
+import QtQuick.Layouts 1.15
+import QtQuick.Controls.Material
+
+import NOWALuaScript
+
+Dialog
+{
+    id: root;
+    width: 800;
+    height: 500;
+    modal: false;
+    title: "Compile Project";
+
+    Material.theme: Material.Yellow;
+    Material.primary: Material.BlueGrey;
+    Material.accent: Material.LightGreen;
+    Material.foreground: "#FFFFFF";
+    Material.background: "#1E1E1E";
+
+    property string summaryText: "";
+
+    function clear()
+    {
+        resultModel.clear();
+        root.summaryText = "Compiling...";
+    }
+
+    function formatSize(size)
+    {
+        return size >= 1024 ? (size / 1024).toFixed(1) + " KB" : size + " B";
+    }
+
+    ListModel
+    {
+        id: resultModel;
+    }
+
+    Connections
+    {
+        target: LuaScriptQmlAdapter;
+
+        function onSignal_bytecodeCompileResult(filePathName, success, sourceSize, bytecodeSize, compileTimeMs, message)
+        {
+            resultModel.append({ "fileName": filePathName.split('/').pop(), "success": success, "sourceSize": sourceSize,
+                                 "bytecodeSize": bytecodeSize, "compileTimeMs": compileTimeMs, "message": message });
+        }
+
+        function onSignal_compileProjectFinished(fileCount, failedCount, sourceSize, bytecodeSize, elapsedMs)
+        {
+            root.summaryText = fileCount + " files, " + failedCount + " failed, source " + root.formatSize(sourceSize)
+                    + ", bytecode " + root.formatSize(bytecodeSize) + ", " + elapsedMs.toFixed(1) + " ms";
+        }
+    }
+
+    ColumnLayout
+    {
+        anchors.fill: parent;
+        spacing: 10;
+
+        Label
+        {
+            text: root.summaryText;
+            font.bold: true;
+        }
+
+        ListView
+        {
+            id: resultListView;
+            Layout.fillWidth: true;
+            Layout.fillHeight: true;
+            clip: true;
+            model: resultModel;
+
+            ScrollBar.vertical: ScrollBar
+            {
+                policy: resultListView.contentHeight > resultListView.height ? ScrollBar.AlwaysOn : ScrollBar.AlwaysOff;
+            }
+
+            delegate: Label
+            {
+                width: resultListView.width - 16;
+                wrapMode: Text.Wrap;
+                color: model.success ? "#FFFFFF" : "red";
+
+                // Per file the size of the source against the bytecode and the time, the game would spend parsing it
+                text: model.success ? model.fileName + ": " + root.formatSize(model.sourceSize) + " -> " + root.formatSize(model.bytecodeSize)
+                                      + ", " + model.compileTimeMs.toFixed(2) + " ms"
+                                    : model.fileName + ": " + model.message;
+            }
+        }
+
+        Button
+        {
+            text: "Close";
+            Layout.alignment: Qt.AlignHCenter;
+
+            onClicked:
+            {
+                root.close();
+            }
+        }
+    }
+}
@@ -16,6 +16,9 @@ Rectangle
 
     property string syntaxErrorText: ""
     property string runtimeErrorText: ""
+    // Per line and message, how often the game reported the error, it is not repeated in runtimeErrorText
+    property var runtimeErrorHits: ({})
+    property string runtimeErrorHitsText: ""
 
     Flickable
     {
@@ -77,7 +80,7 @@ Rectangle
             selectedTextColor: "black";
             selectionColor: "lightgreen";
 
-            text: root.syntaxErrorText + (root.syntaxErrorText !== "" && root.runtimeErrorText !== "" ? "\n" : "") + root.runtimeErrorText;
+            text: root.syntaxErrorText + (root.syntaxErrorText !== "" && root.runtimeErrorText !== "" ? "\n" : "") + root.runtimeErrorText + root.runtimeErrorHitsText;
 
             onCursorRectangleChanged:
             {
@@ -117,6 +120,8 @@ Rectangle
                         {
                             // Clear runtime errors if valid
                             root.runtimeErrorText = "";
+                            root.runtimeErrorHits = {};
+                            root.runtimeErrorHitsText = "";
                         }
                         else
                         {
@@ -129,6 +134,48 @@ Rectangle
                         }
                     }
                 }
+
+                function onSignal_runtimeErrorHitsResult(filePathName, line, message, hitCount, firstTimestamp, lastTimestamp)
+                {
+                    if (filePathName !== root.filePathName)
+                    {
+                        return;
+                    }
+
+                    root.runtimeErrorHits[line + ":" + message] = { line: line, hitCount: hitCount, firstTimestamp: firstTimestamp, lastTimestamp: lastTimestamp };
+
+                    let hitsText = "";
+                    for (let key in root.runtimeErrorHits)
+                    {
+                        let hits = root.runtimeErrorHits[key];
+                        if (hits.hitCount > 1)
+                        {
+                            hitsText += "Line " + hits.line + " reported " + hits.hitCount + " times, first at "
+                                    + Qt.formatTime(new Date(hits.firstTimestamp), "hh:mm:ss") + ", last at "
+                                    + Qt.formatTime(new Date(hits.lastTimestamp), "hh:mm:ss") + "\n";
+                        }
+                    }
+                    root.runtimeErrorHitsText = hitsText;
+                }
+
+                function onSignal_runtimeErrorRecordResult(filePathName, runtimeError)
+                {
+                    if (filePathName === root.filePathName && runtimeError.frames.length > 1)
+                    {
+                        // The traceback below the message, innermost call first
+                        let traceback = "    stack traceback:\n";
+                        for (let i = 1; i < runtimeError.frames.length; ++i)
+                        {
+                            let frame = runtimeError.frames[i];
+                            traceback += "        " + frame.source + (frame.line >= 0 ? ":" + frame.line : "")
+                                    + (frame.functionName !== "" ? " in " + frame.functionName : "") + "\n";
+                        }
+                        if (!root.runtimeErrorText.includes(traceback))
+                        {
+                            root.runtimeErrorText += traceback;
+                        }
+                    }
+                }
             }
         }
     }
@@ -55,17 +55,17 @@ Rectangle
                 var selectedIdentifier;
                 if (p.resultType == "forClass")
                 {
-                    selectedIdentifier = NOWAApiModel.methodsForSelectedClass[p.currentIndex];
+                    selectedIdentifier = NOWAApiModel.methodsForSelectedClass.get(p.currentIndex);
                     NOWALuaEditorModel.sendTextToEditor(selectedIdentifier.name);
                 }
                 else if (p.resultType == "forConstant")
                 {
-                    selectedIdentifier = NOWAApiModel.constantsForSelectedClass[p.currentIndex];
+                    selectedIdentifier = NOWAApiModel.constantsForSelectedClass.get(p.currentIndex);
                     NOWALuaEditorModel.sendTextToEditor(selectedIdentifier.name);
                 }
                 else if (p.resultType == "forVariable")
                 {
-                    selectedIdentifier = NOWAApiModel.matchedVariables[p.currentIndex];
+                    selectedIdentifier = NOWAApiModel.matchedVariables.get(p.currentIndex);
                     NOWALuaEditorModel.sendVariableTextToEditor(selectedIdentifier.name);
                 }
             }
@@ -84,7 +84,7 @@ Rectangle
             var content = "";
             if (p.resultType == "forClass")
             {
-                selectedIdentifier = NOWAApiModel.methodsForSelectedClass[p.currentIndex];
+                selectedIdentifier = NOWAApiModel.methodsForSelectedClass.get(p.currentIndex);
                 if (selectedIdentifier.description)
                 {
                     content = "Details: " + selectedIdentifier.description + "\n" + selectedIdentifier.returns + " " + selectedIdentifier.name + selectedIdentifier.args;
@@ -96,7 +96,7 @@ Rectangle
             }
             else if (p.resultType == "forConstant")
             {
-                selectedIdentifier = NOWAApiModel.constantsForSelectedClass[p.currentIndex];
+                selectedIdentifier = NOWAApiModel.constantsForSelectedClass.get(p.currentIndex);
                 if (selectedIdentifier.description)
                 {
                     content = "Details: Constant: " + selectedIdentifier.description + "\n" + selectedIdentifier.name;
@@ -108,7 +108,7 @@ Rectangle
             }
             else if (p.resultType == "forVariable")
             {
-                selectedIdentifier = NOWAApiModel.matchedVariables[p.currentIndex];
+                selectedIdentifier = NOWAApiModel.matchedVariables.get(p.currentIndex);
                 if (selectedIdentifier.description)
                 {
                     content = "Details: Variable: " + selectedIdentifier.description + "\n" + selectedIdentifier.name + "\nType: " + selectedIdentifier.scope;
@@ -368,25 +368,42 @@ Rectangle
 
                                 text:
                                 {
-                                    var nameText = modelData.name;
+                                    var nameText = model.name;
                                     var preMatch, matchText, postMatch;
 
-                                    if (modelData.startIndex >= 0 && modelData.endIndex > modelData.startIndex)
+                                    if (model.startIndex === -1 && model.matchedPositions !== undefined && model.matchedPositions.length > 0)
                                     {
-                                        preMatch = nameText.substring(0, modelData.startIndex);
-                                        matchText = nameText.substring(modelData.startIndex, modelData.endIndex + 1);
-                                        postMatch = nameText.substring(modelData.endIndex + 1);
+                                        // Fuzzy match, e.g. the humps of "gPAC", each matched character is highlighted
+                                        var highlightedText = "";
+                                        for (var i = 0; i < nameText.length; i++)
+                                        {
+                                            if (model.matchedPositions.indexOf(i) !== -1)
+                                            {
+                                                highlightedText += "<b><span style='color:#FFDAB9;'>" + nameText[i] + "</span></b>";
+                                            }
+                                            else
+                                            {
+                                                highlightedText += nameText[i];
+                                            }
+                                        }
+                                        nameText = highlightedText;
+                                    }
+                                    else if (model.startIndex >= 0 && model.endIndex > model.startIndex)
+                                    {
+                                        preMatch = nameText.substring(0, model.startIndex);
+                                        matchText = nameText.substring(model.startIndex, model.endIndex + 1);
+                                        postMatch = nameText.substring(model.endIndex + 1);
                                         nameText = preMatch + "<b><span style='color:#FFDAB9;'>" + matchText + "</span></b>" + postMatch;
                                     }
 
                                     switch (p.resultType)
                                     {
                                         case "forClass":
-                                            return modelData.returns + " " + nameText + modelData.args;
+                                            return model.returns + " " + nameText + model.args;
                                         case "forConstant":
                                             return nameText;
                                         case "forVariable":
-                                            return "Matched: " +  nameText + " -> Type: '" + modelData.type + "' scope: '" + modelData.scope + "'";
+                                            return "Matched: " +  nameText + " -> Type: '" + model.type + "' scope: '" + model.scope + "'";
                                     }
                                     return "";
                                 }
@@ -417,11 +434,11 @@ Rectangle
                                     NOWAApiModel.isIntellisenseShown = false;
                                     if (p.resultType == "forClass" || p.resultType == "forConstant")
                                     {
-                                        NOWALuaEditorModel.sendTextToEditor(modelData.name);
+                                        NOWALuaEditorModel.sendTextToEditor(model.name);
                                     }
                                     else if (p.resultType == "forVariable")
                                     {
-                                        NOWALuaEditorModel.sendVariableTextToEditor(modelData.name);
+                                        NOWALuaEditorModel.sendVariableTextToEditor(model.name);
                                     }
                                 }
                                 else
@@ -443,7 +460,7 @@ Rectangle
 
                                 onTriggered:
                                 {
-                                    details.text = "Details: " + modelData.description + "\n" + modelData.returns + " " + modelData.name + modelData.args;
+                                    details.text = "Details: " + model.description + "\n" + model.returns + " " + model.name + model.args;
                                 }
                             }
 
@@ -332,6 +332,14 @@ LuaEditorQml
                                 }
                             }
                         }
+
+                        function onSignal_runtimeErrorRecordResult(filePathName, runtimeError)
+                        {
+                            if (filePathName === root.model.filePathName)
+                            {
+                                root.highlightRuntimeErrorFrames(runtimeError.frames);
+                            }
+                        }
                     }
 
                     Connections
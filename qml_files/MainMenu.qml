@@ -72,6 +72,38 @@ MenuBar
        }
     }
 
+    FolderDialog
+    {
+        id: compileProjectFolderDialog;
+        currentFolder: Qt.resolvedUrl("../../media/projects");
+
+        onAccepted:
+        {
+            var selectedFolderPath = compileProjectFolderDialog.selectedFolder.toString();
+
+            if (Qt.platform.os === "windows")
+            {
+                selectedFolderPath = selectedFolderPath.replace("file:///", "");
+            }
+            else
+            {
+                selectedFolderPath = selectedFolderPath.replace("file://", "/");
+            }
+
+            compileResultDialog.clear();
+            compileResultDialog.open();
+            LuaScriptQmlAdapter.compileProject(selectedFolderPath);
+        }
+    }
+
+    CompileResultDialog
+    {
+        id: compileResultDialog;
+
+        x: (parent.width - width) / 2;
+        y: (parent.parent.height - height) / 2;
+    }
+
     // Message dialog for unsaved changes prompt
     MessageDialog
     {
@@ -89,6 +121,20 @@ MenuBar
         }
     }
 
+    MessageDialog
+    {
+        id: saveFailedDialog;
+        visible: false;
+        text: "Lua script could not be saved:";
+        informativeText: "--";
+        buttons: MessageDialog.Ok;
+
+        onAccepted:
+        {
+            saveFailedDialog.visible = false;
+        }
+    }
+
     Connections
     {
         target: LuaScriptQmlAdapter;
@@ -101,6 +147,12 @@ MenuBar
                 messageDialog.visible = true;
             }
         }
+
+        function onSignal_luaScriptSaveFailed(filePathName, message)
+        {
+            saveFailedDialog.informativeText = message;
+            saveFailedDialog.visible = true;
+        }
     }
 
     Menu
@@ -124,6 +176,14 @@ MenuBar
             onTriggered: NOWALuaEditorModel.requestSaveLuaScript();
         }
 
+        Action
+        {
+            text: qsTr("Save All");
+            shortcut: "Ctrl+Shift+S";
+            icon.name: "document-save-all";
+            onTriggered: NOWALuaEditorModel.requestSaveAllLuaScripts();
+        }
+
         MenuSeparator {}
 
         // Repeater to display recent files dynamically
@@ -273,6 +333,42 @@ MenuBar
             icon.name: "folder-open";  // Common icon for opening folders
             onTriggered: NOWALuaEditorModel.openProjectFolder();
         }
+
+        Action
+        {
+            text: qsTr("Find Api Symbol...");
+            shortcut: "Ctrl+Shift+F";
+            onTriggered: symbolSearchDialog.visible = true;
+        }
+
+        MenuSeparator {}
+
+        Action
+        {
+            text: qsTr("Compile On Save");
+            checkable: true;
+            checked: LuaScriptQmlAdapter.compileOnSave;
+            onTriggered: LuaScriptQmlAdapter.compileOnSave = checked;
+        }
+
+        Action
+        {
+            text: qsTr("Strip Debug Info");
+            checkable: true;
+            checked: LuaScriptQmlAdapter.stripDebugInfo;
+            onTriggered: LuaScriptQmlAdapter.stripDebugInfo = checked;
+        }
+
+        Action
+        {
+            text: qsTr("Compile Project...");
+            onTriggered: compileProjectFolderDialog.open();
+        }
+    }
+
+    SymbolSearchDialog
+    {
+        id: symbolSearchDialog;
     }
 
     AboutDialog
@@ -0,0 +1,130 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Controls.Material
+import QtQuick.Layouts
+
+import NOWALuaScript
+
+// Finds the classes of a method or constant, if only its name is remembered
+Window
+{
+    id: root;
+    width: 520;
+    height: 480;
+    visible: false;
+    title: "Find Api Symbol";
+
+    flags: Qt.Window;
+
+    Material.theme: Material.Dark;
+    Material.background: "#1E1E1E";
+
+    onVisibleChanged:
+    {
+        if (visible)
+        {
+            root.raise();
+            root.requestActivate();
+            queryField.forceActiveFocus();
+            queryField.selectAll();
+        }
+    }
+
+    Rectangle
+    {
+        anchors.fill: parent;
+        color: "#1E1E1E";
+    }
+
+    ColumnLayout
+    {
+        anchors.fill: parent;
+        anchors.margins: 8;
+
+        TextField
+        {
+            id: queryField;
+            Layout.fillWidth: true;
+            placeholderText: "Method or constant name, e.g. getPosition";
+
+            onTextChanged: NOWASymbolSearchModel.query = text;
+
+            Keys.onEscapePressed: root.visible = false;
+            Keys.onDownPressed: resultList.incrementCurrentIndex();
+            Keys.onUpPressed: resultList.decrementCurrentIndex();
+            Keys.onReturnPressed: root.insertCurrent();
+        }
+
+        Label
+        {
+            text: NOWASymbolSearchModel.count + " matches in " + NOWASymbolSearchModel.searchMicroseconds.toFixed(1) + " us";
+            color: "lightgray";
+        }
+
+        ListView
+        {
+            id: resultList;
+            Layout.fillWidth: true;
+            Layout.fillHeight: true;
+            clip: true;
+            currentIndex: 0;
+
+            model: NOWASymbolSearchModel;
+
+            ScrollBar.vertical: ScrollBar {}
+
+            delegate: Rectangle
+            {
+                property string symbolNameText: symbolName;
+                property string classNameText: className;
+
+                width: resultList.width;
+                height: 24;
+                color: index === resultList.currentIndex ? "#3A3A3A" : "transparent";
+
+                Text
+                {
+                    anchors.fill: parent;
+                    anchors.leftMargin: 6;
+                    verticalAlignment: Text.AlignVCenter;
+                    elide: Text.ElideRight;
+                    textFormat: Text.RichText;
+                    color: "white";
+
+                    text: kind === "constant" ? "<b>" + className + "</b>." + symbolName
+                                              : returns + " <b>" + className + "</b>:" + symbolName + args;
+                }
+
+                ToolTip.visible: itemMouseArea.containsMouse && description !== "";
+                ToolTip.text: description;
+
+                MouseArea
+                {
+                    id: itemMouseArea;
+                    anchors.fill: parent;
+                    hoverEnabled: true;
+
+                    onClicked: resultList.currentIndex = index;
+                    onDoubleClicked:
+                    {
+                        resultList.currentIndex = index;
+                        root.insertCurrent();
+                    }
+                }
+            }
+        }
+    }
+
+    // Shows the class in the details area and writes the name into the editor
+    function insertCurrent()
+    {
+        if (resultList.currentItem === null)
+        {
+            return;
+        }
+
+        NOWAApiModel.selectedClassName = resultList.currentItem.classNameText;
+        NOWALuaEditorModel.insertTextAtCursor(resultList.currentItem.symbolNameText);
+        root.visible = false;
+    }
+}
@@ -0,0 +1,318 @@
+// Fake NOWA-Design, which measures the latency from a reported runtime error to the highlighted line in a running NOWALuaScript:
+// nowa_ipc_bench --transport ipc --scripts 4 --open-rate 2 --error-rate 60 --duration 10
+// The scripts are generated into a temporary folder. Their paths are sent as LuaScriptPath and runtime errors at random lines of
+// them as LuaRuntimeErrors, both stamped with the steady clock, through one of the ways AppCommunicator reads:
+// ipc (IpcServer), journal (MessageJournal), xml (the watched folder) or ring (DiagnosticsRing).
+// Afterwards the editor writes what its LatencyProbe measured, p50, p99 and p999 until AppCommunicator and until
+// LuaHighlighter::setRuntimeErrorLine.
+// The editor must be built with NOWA_IPC_TOOLS as well, release editors neither measure nor write a report.
+
+#include "backend/ipcprotocol.h"
+#include "backend/ipcclient.h"
+#include "backend/diagnosticsring.h"
+#include "backend/latencyprobe.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QXmlStreamWriter>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QRandomGenerator>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cstdio>
+
+// TARGET_PATH will be set by CMake at compile time
+#ifndef TARGET_PATH
+#define TARGET_PATH ""
+#endif
+
+namespace
+{
+    const int scriptLineCount = 200;
+
+    void printStage(const char* name, const QJsonObject& stage)
+    {
+        printf("%-12s count %6lld  p50 %10.1f us  p99 %10.1f us  p999 %10.1f us  max %10.1f us\n", name,
+               static_cast<long long>(stage["count"].toInteger()), stage["p50Us"].toDouble(), stage["p99Us"].toDouble(),
+               stage["p999Us"].toDouble(), stage["maxUs"].toDouble());
+    }
+}
+
+class Emitter
+{
+public:
+    explicit Emitter(const QString& transport)
+        : transport(transport),
+        ipcClient(IpcProtocol::ipcServerName),
+        sequence(0),
+        xmlFileCount(0)
+    {
+        this->messageFolder = QString(TARGET_PATH) + "/NOWALuaScript/bin/";
+    }
+
+    bool open(void)
+    {
+        if ("ipc" == this->transport)
+        {
+            this->ipcClient.connectToServer();
+            return true;
+        }
+        if ("journal" == this->transport)
+        {
+            // A new journal is smaller than the old one, so the editor starts over with the sequences
+            // Like MessageJournal::defaultFilePathName
+            this->journalFile.setFileName(this->messageFolder + "journal/lua_script_messages.journal");
+            return this->journalFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        }
+        if ("ring" == this->transport)
+        {
+            if (false == this->diagnosticsRing.attach())
+            {
+                fprintf(stderr, "%s\n", qPrintable(this->diagnosticsRing.getErrorString()));
+                return false;
+            }
+            return true;
+        }
+        return "xml" == this->transport;
+    }
+
+    void send(IpcProtocol::Message message)
+    {
+        message.sequence = ++this->sequence;
+
+        if ("ipc" == this->transport)
+        {
+            this->ipcClient.send(message);
+        }
+        else if ("journal" == this->transport)
+        {
+            this->frame.resize(0);
+            IpcProtocol::encode(message, this->frame);
+            this->journalFile.write(this->frame);
+            this->journalFile.flush();
+        }
+        else if ("ring" == this->transport)
+        {
+            this->diagnosticsRing.write(message);
+        }
+        else
+        {
+            this->writeXml(message);
+        }
+    }
+
+    void close(void)
+    {
+        this->ipcClient.finish();
+        this->journalFile.close();
+    }
+private:
+    void writeXml(const IpcProtocol::Message& message)
+    {
+        // Renamed into place, so that the editor never reads half a file
+        QSaveFile xmlFile(this->messageFolder + QString("lua_script_bench_%1.xml").arg(++this->xmlFileCount));
+        if (false == xmlFile.open(QIODevice::WriteOnly))
+        {
+            return;
+        }
+
+        QXmlStreamWriter xmlWriter(&xmlFile);
+        xmlWriter.writeStartDocument();
+        xmlWriter.writeStartElement("Message");
+        xmlWriter.writeTextElement("MessageId", IpcProtocol::MessageType::LuaScriptPath == message.type ? "LuaScriptPath" : "LuaRuntimeErrors");
+        xmlWriter.writeTextElement("FilePath", message.filePathName);
+        if (IpcProtocol::MessageType::LuaRuntimeErrors == message.type)
+        {
+            xmlWriter.writeStartElement("error");
+            xmlWriter.writeAttribute("line", QString::number(message.line));
+            xmlWriter.writeAttribute("start", QString::number(message.start));
+            xmlWriter.writeAttribute("end", QString::number(message.end));
+            xmlWriter.writeAttribute("timestamp", QString::number(message.timestamp));
+            xmlWriter.writeCharacters(message.errorMessage);
+            xmlWriter.writeEndElement();
+        }
+        xmlWriter.writeEndElement();
+        xmlWriter.writeEndDocument();
+        xmlFile.commit();
+    }
+private:
+    QString transport;
+    QString messageFolder;
+    IpcClient ipcClient;
+    DiagnosticsRing diagnosticsRing;
+    QFile journalFile;
+    QByteArray frame;
+    quint32 sequence;
+    int xmlFileCount;
+};
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures the latency from a runtime error of the game to the highlighted line in NOWALuaScript.");
+    parser.addHelpOption();
+
+    QCommandLineOption transportOption("transport", "ipc, journal, xml or ring.", "transport", "ipc");
+    QCommandLineOption scriptsOption("scripts", "Count of generated scripts.", "count", "4");
+    QCommandLineOption linesOption("lines", "Count of distinct error lines per script.", "count", "20");
+    QCommandLineOption openRateOption("open-rate", "LuaScriptPath messages per second.", "rate", "2");
+    QCommandLineOption errorRateOption("error-rate", "LuaRuntimeErrors messages per second.", "rate", "60");
+    QCommandLineOption durationOption("duration", "Seconds to send.", "seconds", "10");
+
+    parser.addOptions({ transportOption, scriptsOption, linesOption, openRateOption, errorRateOption, durationOption });
+    parser.process(app);
+
+    const QString transport = parser.value(transportOption);
+    const int scriptCount = qMax(1, parser.value(scriptsOption).toInt());
+    const int lineCount = qBound(1, parser.value(linesOption).toInt(), scriptLineCount);
+    const double openRate = qMax(0.0, parser.value(openRateOption).toDouble());
+    const double errorRate = qMax(0.0, parser.value(errorRateOption).toDouble());
+    const qint64 durationMs = qMax(1, parser.value(durationOption).toInt()) * 1000;
+
+    // The editor keeps the scripts open, so the folder stays
+    QTemporaryDir scriptFolder;
+    scriptFolder.setAutoRemove(false);
+
+    QStringList scriptFilePathNames;
+    for (int i = 0; i < scriptCount; ++i)
+    {
+        const QString filePathName = scriptFolder.filePath(QString("BenchScript%1.lua").arg(i));
+        QFile scriptFile(filePathName);
+        if (false == scriptFile.open(QIODevice::WriteOnly | QIODevice::Text))
+        {
+            fprintf(stderr, "Could not write %s\n", qPrintable(filePathName));
+            return 1;
+        }
+        for (int line = 1; line <= scriptLineCount; ++line)
+        {
+            scriptFile.write(QString("local value%1 = getValue(%1)\n").arg(line).toUtf8());
+        }
+        scriptFilePathNames.append(filePathName);
+    }
+
+    Emitter emitter(transport);
+    if (false == emitter.open())
+    {
+        fprintf(stderr, "Could not open transport %s\n", qPrintable(transport));
+        return 1;
+    }
+
+    printf("Sending over %s for %lld ms: %.1f opens/s, %.1f errors/s, scripts in %s\n", qPrintable(transport),
+           static_cast<long long>(durationMs), openRate, errorRate, qPrintable(scriptFolder.path()));
+
+    // Every script is opened once first, the measured errors then mostly hit open scripts
+    for (const QString& filePathName : scriptFilePathNames)
+    {
+        IpcProtocol::Message message;
+        message.type = IpcProtocol::MessageType::LuaScriptPath;
+        message.filePathName = filePathName;
+        emitter.send(message);
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+
+    qint64 openCount = 0;
+    qint64 errorCount = 0;
+
+    // Each tick sends, what is due by the rates, so that a slow tick does not lower the rate
+    QTimer sendTimer;
+    sendTimer.setTimerType(Qt::PreciseTimer);
+    sendTimer.setInterval(1);
+
+    QObject::connect(&sendTimer, &QTimer::timeout, [&]()
+                     {
+                         const qint64 elapsedMs = clock.elapsed();
+                         QRandomGenerator* random = QRandomGenerator::global();
+
+                         while (openCount < static_cast<qint64>(openRate * elapsedMs / 1000.0))
+                         {
+                             IpcProtocol::Message message;
+                             message.type = IpcProtocol::MessageType::LuaScriptPath;
+                             message.filePathName = scriptFilePathNames[random->bounded(scriptCount)];
+                             emitter.send(message);
+                             ++openCount;
+                         }
+
+                         while (errorCount < static_cast<qint64>(errorRate * elapsedMs / 1000.0))
+                         {
+                             const QString filePathName = scriptFilePathNames[random->bounded(scriptCount)];
+
+                             IpcProtocol::Message message;
+                             message.type = IpcProtocol::MessageType::LuaRuntimeErrors;
+                             message.filePathName = filePathName;
+                             message.line = 1 + random->bounded(lineCount);
+                             message.start = 0;
+                             message.end = 0;
+                             message.errorMessage = QString("%1:%2: attempt to call global 'getValue' (a nil value)")
+                                                        .arg(QFileInfo(filePathName).fileName()).arg(message.line);
+                             message.timestamp = LatencyProbe::now();
+                             emitter.send(message);
+                             ++errorCount;
+                         }
+
+                         if (elapsedMs >= durationMs)
+                         {
+                             sendTimer.stop();
+                             emitter.close();
+                         }
+                     });
+
+    sendTimer.start();
+
+    // The editor needs a moment for the last coalesced errors, then it is asked for its measurements
+    const QString reportFilePathName = scriptFolder.filePath("latency.json");
+    IpcClient reportClient(IpcProtocol::ipcServerName);
+
+    QTimer::singleShot(durationMs + 1000, [&]()
+                       {
+                           IpcProtocol::Message message;
+                           message.type = IpcProtocol::MessageType::Command;
+                           message.command = "latencyReport";
+                           message.filePathName = reportFilePathName;
+                           reportClient.send(message);
+                           reportClient.connectToServer();
+                           reportClient.finish();
+                       });
+
+    QTimer reportTimer;
+    int reportPolls = 0;
+    QObject::connect(&reportTimer, &QTimer::timeout, [&]()
+                     {
+                         QFile reportFile(reportFilePathName);
+                         if (false == reportFile.open(QIODevice::ReadOnly))
+                         {
+                             if (++reportPolls > 50)
+                             {
+                                 fprintf(stderr, "NOWALuaScript did not write a latency report\n");
+                                 app.exit(1);
+                             }
+                             return;
+                         }
+
+                         const QJsonObject report = QJsonDocument::fromJson(reportFile.readAll()).object();
+
+                         printf("Sent %lld opens and %lld errors\n", static_cast<long long>(openCount), static_cast<long long>(errorCount));
+                         printStage("received", report["received"].toObject());
+                         printStage("highlighted", report["highlighted"].toObject());
+                         printf("Coalesced %lld, not highlighted %lld\n", static_cast<long long>(report["coalesced"].toInteger()),
+                                static_cast<long long>(report["notHighlighted"].toInteger()));
+                         app.exit(0);
+                     });
+
+    QTimer::singleShot(durationMs + 1100, [&]()
+                       {
+                           reportTimer.start(100);
+                       });
+
+    return app.exec();
+}
@@ -0,0 +1,190 @@
+// Stand-in for NOWA-Design on the ipc channel of NOWALuaScript, for testing without the engine:
+// nowa_ipc_client --open <script.lua>
+// nowa_ipc_client --error <script.lua> --line 12 --message "Player.lua:12: attempt to index a nil value"
+// nowa_ipc_client --ping 10000
+// nowa_ipc_client --error <script.lua> --line 12 --count 100000 --ring
+// Every message is sent --count times over one connection. Pings measure the round trip to the editor and back.
+// With --ring runtime errors are written into the shared memory DiagnosticsRing instead, like the game does.
+
+#include "backend/ipcprotocol.h"
+#include "backend/diagnosticsring.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QLocalSocket>
+#include <QElapsedTimer>
+#include <QList>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    double percentile(const QList<qint64>& sortedValues, double fraction)
+    {
+        const qsizetype index = qMin(sortedValues.size() - 1, static_cast<qsizetype>(fraction * sortedValues.size()));
+        return sortedValues[index] / 1000.0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Sends messages to a running NOWALuaScript like NOWA-Design does.");
+    parser.addHelpOption();
+
+    QCommandLineOption openOption("open", "Opens the script in the editor.", "file");
+    QCommandLineOption errorOption("error", "Sends a runtime error for the script.", "file");
+    QCommandLineOption lineOption("line", "Line of the runtime error.", "line", "-1");
+    QCommandLineOption messageOption("message", "Message of the runtime error.", "message", "runtime error");
+    QCommandLineOption pingOption("ping", "Measures the round trip with the given count of pings.", "count");
+    QCommandLineOption countOption("count", "How often the message is sent.", "count", "1");
+    QCommandLineOption ringOption("ring", "Writes the runtime errors into the diagnostics ring in shared memory.");
+
+    parser.addOptions({ openOption, errorOption, lineOption, messageOption, pingOption, countOption, ringOption });
+    parser.process(app);
+
+    if (true == parser.isSet(ringOption))
+    {
+        DiagnosticsRing diagnosticsRing;
+        if (false == diagnosticsRing.attach())
+        {
+            fprintf(stderr, "%s\n", qPrintable(diagnosticsRing.getErrorString()));
+            return 1;
+        }
+
+        IpcProtocol::Message message;
+        message.type = IpcProtocol::MessageType::LuaRuntimeErrors;
+        message.filePathName = parser.value(errorOption);
+        message.errorMessage = parser.value(messageOption);
+        message.line = parser.value(lineOption).toInt();
+
+        const int count = qMax(1, parser.value(countOption).toInt());
+        int written = 0;
+
+        QElapsedTimer clock;
+        clock.start();
+
+        for (int i = 0; i < count; ++i)
+        {
+            message.sequence = static_cast<quint32>(i + 1);
+            if (true == diagnosticsRing.write(message))
+            {
+                ++written;
+            }
+        }
+
+        printf("Wrote %d of %d runtime errors in %.1f us, dropped in total: %llu\n", written, count, clock.nsecsElapsed() / 1000.0,
+               static_cast<unsigned long long>(diagnosticsRing.getDroppedCount()));
+        return 0;
+    }
+
+    QLocalSocket socket;
+    socket.connectToServer(IpcProtocol::ipcServerName);
+
+    if (false == socket.waitForConnected(1000))
+    {
+        fprintf(stderr, "Could not connect to NOWALuaScript: %s\n", qPrintable(socket.errorString()));
+        return 1;
+    }
+
+    quint32 sequence = 0;
+    const int count = qMax(1, parser.value(countOption).toInt());
+
+    QByteArray frames;
+
+    for (int i = 0; i < count; ++i)
+    {
+        IpcProtocol::Message message;
+
+        if (true == parser.isSet(openOption))
+        {
+            message.type = IpcProtocol::MessageType::LuaScriptPath;
+            message.sequence = ++sequence;
+            message.filePathName = parser.value(openOption);
+            IpcProtocol::encode(message, frames);
+        }
+
+        if (true == parser.isSet(errorOption))
+        {
+            message.type = IpcProtocol::MessageType::LuaRuntimeErrors;
+            message.sequence = ++sequence;
+            message.filePathName = parser.value(errorOption);
+            message.errorMessage = parser.value(messageOption);
+            message.line = parser.value(lineOption).toInt();
+            IpcProtocol::encode(message, frames);
+        }
+    }
+
+    if (false == frames.isEmpty())
+    {
+        socket.write(frames);
+        socket.waitForBytesWritten(1000);
+        printf("Sent %u messages, %lld bytes\n", sequence, static_cast<long long>(frames.size()));
+    }
+
+    if (true == parser.isSet(pingOption))
+    {
+        const int pingCount = qMax(1, parser.value(pingOption).toInt());
+
+        QElapsedTimer clock;
+        clock.start();
+
+        IpcProtocol::FrameReader frameReader;
+        QList<qint64> roundTrips;
+        roundTrips.reserve(pingCount);
+
+        // One ping at a time, so that each round trip is measured without queueing behind the others
+        for (int i = 0; i < pingCount; ++i)
+        {
+            IpcProtocol::Message ping;
+            ping.type = IpcProtocol::MessageType::Ping;
+            ping.sequence = ++sequence;
+            ping.timestamp = clock.nsecsElapsed();
+
+            QByteArray frame;
+            IpcProtocol::encode(ping, frame);
+            socket.write(frame);
+            socket.flush();
+
+            IpcProtocol::Message pong;
+            bool received = false;
+
+            while (false == received)
+            {
+                if (false == socket.waitForReadyRead(1000))
+                {
+                    fprintf(stderr, "No pong from NOWALuaScript: %s\n", qPrintable(socket.errorString()));
+                    return 1;
+                }
+
+                frameReader.append(socket.readAll());
+
+                while (true == frameReader.next(pong))
+                {
+                    if (IpcProtocol::MessageType::Pong == pong.type)
+                    {
+                        roundTrips.append(clock.nsecsElapsed() - pong.timestamp);
+                        received = true;
+                    }
+                }
+            }
+        }
+
+        std::sort(roundTrips.begin(), roundTrips.end());
+
+        printf("Round trips: %d, min %.1f us, p50 %.1f us, p99 %.1f us, max %.1f us\n", pingCount, roundTrips.first() / 1000.0,
+               percentile(roundTrips, 0.5), percentile(roundTrips, 0.99), roundTrips.last() / 1000.0);
+    }
+
+    // Pending frames are still written, before the connection is closed
+    socket.disconnectFromServer();
+    if (QLocalSocket::UnconnectedState != socket.state())
+    {
+        socket.waitForDisconnected(1000);
+    }
+
+    return 0;
+}